@@ -0,0 +1,222 @@
+﻿//
+//      ██╗██████╗     ██╗     ██╗██████╗ ███████╗
+//      ██║██╔══██╗    ██║     ██║██╔══██╗██╔════╝		** MiniaudioCpp **
+//      ██║██████╔╝    ██║     ██║██████╔╝███████╗
+// ██   ██║██╔═══╝     ██║     ██║██╔══██╗╚════██║		https://github.com/Jaytheway/MiniaudioCpp
+// ╚█████╔╝██║         ███████╗██║██████╔╝███████║
+//  ╚════╝ ╚═╝         ╚══════╝╚═╝╚═════╝ ╚══════╝
+//
+//   Copyright 2024 Jaroslav Pevno, MiniaudioCpp is offered under the terms of the ISC license:
+//
+//   Permission to use, copy, modify, and/or distribute this software for any purpose with or
+//   without fee is hereby granted, provided that the above copyright notice and this permission
+//   notice appear in all copies. THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+//   WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+//   AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+//   CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+//   WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+//   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#pragma once
+
+#include "Core.h"
+#include "MiniaudioWrappers.h"
+
+#include "miniaudio/miniaudio.h"
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace JPL
+{
+	//==========================================================================
+	/// Cache of fully decoded audio assets, keyed by file path or ID.
+	///
+	/// Assets are decoded once through the engine's VFS into 32-bit float PCM,
+	/// in their native channel count and sample rate, and shared by all of the
+	/// sounds playing them. Loading an asset that is already cached only bumps its refcount.
+	///
+	/// The total size of decoded data is kept within the budget: assets that are
+	/// no longer referenced stay cached, and are evicted in least recently used order
+	/// to make room. Referenced and pinned assets are never evicted; if the new asset
+	/// doesn't fit even after evicting everything else, loading fails without evicting anything.
+	///
+	/// Loading and releasing take a lock, and loading decodes the whole file while
+	/// holding it, so both should be done on a game or loading thread.
+	/// The cache must outlive all of the handles and sounds using it.
+	///
+	/// Usage:
+	///		AssetCache cache;
+	///		cache.Init(engine, { .BudgetInBytes = 32 * 1024 * 1024 });
+	///		cache.Pin("ui_click.wav");
+	///		...
+	///		CachedSound sound;
+	///		sound.Init(cache, "explosion.wav");
+	///		sound->Start();
+	class AssetCache
+	{
+		struct Asset;
+
+	public:
+		struct CacheSettings
+		{
+			uint64 BudgetInBytes = 64 * 1024 * 1024;
+		};
+
+		//======================================================================
+		/// Reference to a cached asset, keeps it from being evicted
+		class Handle
+		{
+		public:
+			Handle() = default;
+			~Handle() { Reset(); }
+
+			Handle(const Handle& other);
+			Handle& operator=(const Handle& other);
+			Handle(Handle&& other) noexcept;
+			Handle& operator=(Handle&& other) noexcept;
+
+			void Reset();
+			explicit operator bool() const { return mAsset != nullptr; }
+
+			// Interleaved frames
+			std::span<const float> GetData() const;
+			uint32 GetNumChannels() const;
+			uint32 GetSampleRate() const;
+			uint64 GetLengthInFrames() const;
+
+		private:
+			friend class AssetCache;
+			Handle(AssetCache* cache, Asset* asset) : mCache(cache), mAsset(asset) {}
+
+			AssetCache* mCache = nullptr;
+			Asset* mAsset = nullptr;
+		};
+
+		AssetCache() = default;
+		~AssetCache();
+
+		AssetCache(const AssetCache&) = delete;
+		AssetCache& operator=(const AssetCache&) = delete;
+
+		bool Init(Engine& engine, const CacheSettings& settings);
+		bool IsInitialized() const { return mEngine != nullptr; }
+
+		Engine* GetEngine() const { return mEngine; }
+
+		// Get the cached asset, or decode it if it's not cached.
+		// @returns empty handle if the asset failed to decode or doesn't fit the budget
+		Handle Load(std::string_view filePathOrId);
+
+		// Keep the asset cached even when not referenced, loading it if needed
+		bool Pin(std::string_view filePathOrId);
+		void Unpin(std::string_view filePathOrId);
+
+		// Evicts unreferenced assets if the new budget is lower than the used memory
+		void SetBudget(uint64 budgetInBytes);
+		uint64 GetBudget() const;
+
+		// Evict all of the assets that are not referenced or pinned
+		void Trim();
+
+		bool IsCached(std::string_view filePathOrId) const;
+
+		uint64 GetUsedBytes() const;
+		uint32 GetNumAssets() const;
+		uint64 GetNumHits() const;
+		uint64 GetNumMisses() const;
+		uint64 GetNumEvictions() const;
+
+	private:
+		struct Asset
+		{
+			std::string Key;
+			float* Data = nullptr;	// Allocated by the decoder, with the engine's allocation callbacks
+			uint64 NumFrames = 0;
+			uint32 NumChannels = 0;
+			uint32 SampleRate = 0;
+			uint64 SizeInBytes = 0;
+
+			uint32 RefCount = 0;
+			bool bPinned = false;
+			std::list<Asset*>::iterator LRUPosition;	// Valid if the asset is evictable
+		};
+
+		struct KeyHash
+		{
+			using is_transparent = void;
+			size_t operator()(std::string_view key) const { return std::hash<std::string_view>{}(key); }
+		};
+
+		using AssetMap = std::unordered_map<std::string, std::unique_ptr<Asset>, KeyHash, std::equal_to<>>;
+
+		// All of the private functions must be called with the mutex locked
+
+		Asset* LoadLocked(std::string_view filePathOrId);
+		void AddRef(Asset& asset);
+		void Release(Asset& asset);
+
+		bool IsEvictable(const Asset& asset) const { return asset.RefCount == 0 && !asset.bPinned; }
+
+		// @returns true if 'sizeInBytes' more fits the budget once everything evictable is evicted
+		bool CanFit(uint64 sizeInBytes) const { return mUsedBytes - mEvictableBytes + sizeInBytes <= mSettings.BudgetInBytes; }
+
+		// Evict least recently used assets until 'sizeInBytes' more fits the budget.
+		// @returns false if it can't fit
+		bool MakeRoom(uint64 sizeInBytes);
+
+		void AddToLRU(Asset& asset);
+		void RemoveFromLRU(Asset& asset);
+		void Evict(Asset& asset);
+
+	private:
+		Engine* mEngine = nullptr;
+		CacheSettings mSettings;
+		ma_vfs* mVFS = nullptr;
+		ma_allocation_callbacks mAllocationCallbacks{};	// Copied from the engine to free the data
+
+		mutable std::mutex mMutex;
+		AssetMap mAssets;
+		std::list<Asset*> mLRU;	// Evictable assets, most recently used first
+		uint64 mUsedBytes = 0;
+		uint64 mEvictableBytes = 0;	// Size of the assets in mLRU
+
+		uint64 mNumHits = 0;
+		uint64 mNumMisses = 0;
+		uint64 mNumEvictions = 0;
+	};
+
+	//==========================================================================
+	/// Sound playing an asset from AssetCache, keeps the asset loaded while initialized.
+	/// Each sound has its own cursor into the shared decoded data.
+	class CachedSound
+	{
+	public:
+		CachedSound() = default;
+		~CachedSound() { Uninit(); }
+
+		// The sound refers to its own data source, so it can't be moved or copied
+		CachedSound(const CachedSound&) = delete;
+		CachedSound& operator=(const CachedSound&) = delete;
+
+		bool Init(AssetCache& cache, std::string_view filePathOrId, uint32_t flags = 0);
+		void Uninit();
+
+		explicit operator bool() const { return static_cast<bool>(mSound); }
+
+		Sound& GetSound() { return mSound; }
+		Sound* operator->() { return &mSound; }
+
+		const AssetCache::Handle& GetAsset() const { return mAsset; }
+
+	private:
+		AssetCache::Handle mAsset;
+		ma_audio_buffer_ref mBufferRef{};
+		Sound mSound;
+	};
+} // namespace JPL
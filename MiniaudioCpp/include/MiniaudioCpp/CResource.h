@@ -27,8 +27,26 @@
 namespace JPL::Internal
 {
 	//==========================================================================
-	/// Utility to handle lifetime of some kind of C resoruce
-	template<typename ResourceType, auto InitFunction, auto UninitFunction>
+	/// Allocation policy of CResource, provides storage for the C resource.
+	/// Storage is value-initialized by Allocate, InitFunction is called on it afterwards.
+	template<typename Policy, typename ResourceType>
+	concept c_allocation_policy = requires(ResourceType* resource)
+	{
+		{ Policy::template Allocate<ResourceType>() } -> std::same_as<ResourceType*>;
+		Policy::template Deallocate<ResourceType>(resource);
+	};
+
+	/// Each resource is a separate heap allocation
+	struct HeapAllocation
+	{
+		template<typename T> static T* Allocate() { return new T(); }
+		template<typename T> static void Deallocate(T* resource) { delete resource; }
+	};
+
+	//==========================================================================
+	/// Utility to handle lifetime of some kind of C resoruce.
+	/// Pointers passed to the constructor or 'reset' must be allocated with the same AllocationPolicy.
+	template<typename ResourceType, auto InitFunction, auto UninitFunction, typename AllocationPolicy = HeapAllocation>
 	class CResource
 	{
 	public:
@@ -44,6 +62,7 @@ namespace JPL::Internal
 
 		static_assert(std::is_function_v<std::remove_pointer_t<Constructor>>, "CResource requires a C initialization function.");
 		static_assert(std::is_invocable_v<Destructor, pointer>, "CResoruce requires uninitialization function");
+		static_assert(c_allocation_policy<AllocationPolicy, ResourceType>, "CResource requires a valid allocation policy.");
 
 	public:
 		[[nodiscard]] constexpr CResource() noexcept = default;
@@ -77,10 +96,26 @@ namespace JPL::Internal
 		[[nodiscard]] constexpr auto emplace(Args&&... args)
 		{
 			destruct();
-			resource_ = new element_type();
+			resource_ = AllocationPolicy::template Allocate<element_type>();
 			return InitFunction(std::forward<Args>(args)..., resource_);
 		}
 
+		// Replace the resource with new storage, to be initialized by the caller
+		// with an init function other than InitFunction.
+		constexpr pointer allocate()
+		{
+			destruct();
+			resource_ = AllocationPolicy::template Allocate<element_type>();
+			return resource_;
+		}
+
+		// Free the storage without uninitializing the resource, e.g. if its initialization failed
+		constexpr void discard() noexcept
+		{
+			if (resource_)
+				AllocationPolicy::template Deallocate<element_type>(std::exchange(resource_, nullptr));
+		}
+
 		constexpr void reset(pointer ptr = nullptr) noexcept
 		{
 			destruct();
@@ -117,7 +152,7 @@ namespace JPL::Internal
 			if (resource_)
 			{
 				UninitFunction(resource_);
-				delete resource_;
+				AllocationPolicy::template Deallocate<element_type>(resource_);
 			}
 		}
 
@@ -125,10 +160,10 @@ namespace JPL::Internal
 		pointer resource_ = nullptr;
 	};
 
-	template<typename ResourceType, auto InitFunction, auto UninitFunction>
+	template<typename ResourceType, auto InitFunction, auto UninitFunction, typename AllocationPolicy>
 	constexpr void swap(
-		CResource<ResourceType, InitFunction, UninitFunction>& lhs,
-		CResource<ResourceType, InitFunction, UninitFunction>& rhs) noexcept
+		CResource<ResourceType, InitFunction, UninitFunction, AllocationPolicy>& lhs,
+		CResource<ResourceType, InitFunction, UninitFunction, AllocationPolicy>& rhs) noexcept
 	{
 		lhs.swap(rhs);
 	}
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "CResource.h"
+#include "SlabPool.h"
 #include "miniaudio/miniaudio.h"
 
 #include <tuple>
@@ -108,23 +109,26 @@ namespace JPL
 
 		using NodeBase = Internal::CResource<ma_node_base, ma_node_init, impl::uninit<ma_node_uninit>>;
 
-		using SplitterNode = Internal::CResource<ma_splitter_node, ma_splitter_node_init, impl::uninit<ma_splitter_node_uninit>>;
+		// Nodes and sounds are created and destroyed often, they are allocated from slabs, see SlabPool.
+		// Engine and data sources are few and may be passed in by the user, so they stay on the heap.
+
+		using SplitterNode = Internal::CResource<ma_splitter_node, ma_splitter_node_init, impl::uninit<ma_splitter_node_uninit>, SlabAllocation>;
 
 		// base_node_t must be either ma_node_base or a struct with ma_node_base as the first member and not a pointer
 		template<typename base_node_t>
-		using TNodeBase = Internal::CResource<base_node_t, ma_node_init, impl::uninit<ma_node_uninit>>;
+		using TNodeBase = Internal::CResource<base_node_t, ma_node_init, impl::uninit<ma_node_uninit>, SlabAllocation>;
 
 		// Should be used carefuly, initialized only in the main centralized engine class.
 		// Output bus access should be prohibited.
 		using Engine = Internal::CResource<ma_engine, ma_engine_init, impl::uninit<ma_engine_uninit>>;
 
-		using EngineNode = Internal::CResource<ma_engine_node, ma_engine_node_init, impl::uninit<ma_engine_node_uninit>>;
+		using EngineNode = Internal::CResource<ma_engine_node, ma_engine_node_init, impl::uninit<ma_engine_node_uninit>, SlabAllocation>;
 
 		// For now we only handle init from file (or hashed file path as string)
-		using Sound = Internal::CResource<ma_sound, ma_sound_init_from_file, impl::uninit<ma_sound_uninit>>;
+		using Sound = Internal::CResource<ma_sound, ma_sound_init_from_file, impl::uninit<ma_sound_uninit>, SlabAllocation>;
 
-		using LPFNode = Internal::CResource<ma_lpf_node, ma_lpf_node_init, impl::uninit<ma_lpf_node_uninit>>;
-		using HPFNode = Internal::CResource<ma_hpf_node, ma_hpf_node_init, impl::uninit<ma_hpf_node_uninit>>;
+		using LPFNode = Internal::CResource<ma_lpf_node, ma_lpf_node_init, impl::uninit<ma_lpf_node_uninit>, SlabAllocation>;
+		using HPFNode = Internal::CResource<ma_hpf_node, ma_hpf_node_init, impl::uninit<ma_hpf_node_uninit>, SlabAllocation>;
 	} // namespace Internal
 } // namespace JPL
 
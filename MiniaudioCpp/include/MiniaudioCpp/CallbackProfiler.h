@@ -0,0 +1,209 @@
+﻿//
+//      ██╗██████╗     ██╗     ██╗██████╗ ███████╗
+//      ██║██╔══██╗    ██║     ██║██╔══██╗██╔════╝		** MiniaudioCpp **
+//      ██║██████╔╝    ██║     ██║██████╔╝███████╗
+// ██   ██║██╔═══╝     ██║     ██║██╔══██╗╚════██║		https://github.com/Jaytheway/MiniaudioCpp
+// ╚█████╔╝██║         ███████╗██║██████╔╝███████║
+//  ╚════╝ ╚═╝         ╚══════╝╚═╝╚═════╝ ╚══════╝
+//
+//   Copyright 2024 Jaroslav Pevno, MiniaudioCpp is offered under the terms of the ISC license:
+//
+//   Permission to use, copy, modify, and/or distribute this software for any purpose with or
+//   without fee is hereby granted, provided that the above copyright notice and this permission
+//   notice appear in all copies. THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+//   WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+//   AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+//   CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+//   WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+//   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#pragma once
+
+#include "Core.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+
+namespace JPL
+{
+	//==========================================================================
+	/// Histogram that is written by a single thread (e.g. the audio thread)
+	/// and can be read from any other thread without locks.
+	///
+	/// Values outside of the range are accumulated in the first and the last bins.
+	/// Bins are read individually, so a snapshot taken while the writer is active
+	/// may be off by the values added during the read.
+	template<uint32 NumBins>
+	class AtomicHistogram
+	{
+	public:
+		enum class EScale
+		{
+			Linear,		// Bins of equal width in [min, max)
+			Log2		// 'BinsPerOctave' bins per each power of two in [min, max)
+		};
+
+		static constexpr uint32 BinsPerOctave = 4;
+
+		constexpr AtomicHistogram(EScale scale, double rangeMin, double rangeMax)
+			: mScale(scale), mRangeMin(rangeMin), mRangeMax(rangeMax)
+		{
+		}
+
+		// Writer thread only
+		void Add(double value)
+		{
+			std::atomic<uint64>& bin = mBins[GetBinIndex(value)];
+			bin.store(bin.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		}
+
+		// Must not be called concurrently with Add
+		void Reset()
+		{
+			for (std::atomic<uint64>& bin : mBins)
+				bin.store(0, std::memory_order_relaxed);
+		}
+
+		static constexpr uint32 GetNumBins() { return NumBins; }
+		uint64 GetBinCount(uint32 binIndex) const { return mBins[binIndex].load(std::memory_order_relaxed); }
+
+		uint64 GetTotalCount() const
+		{
+			uint64 total = 0;
+			for (const std::atomic<uint64>& bin : mBins)
+				total += bin.load(std::memory_order_relaxed);
+			return total;
+		}
+
+		// Lower bound of the values that fall into the bin
+		double GetBinLowerBound(uint32 binIndex) const
+		{
+			if (mScale == EScale::Linear)
+				return mRangeMin + (mRangeMax - mRangeMin) * binIndex / NumBins;
+			else
+				return mRangeMin * std::exp2(static_cast<double>(binIndex) / BinsPerOctave);
+		}
+
+		// Approximate value below which 'percentile' [0, 1] of the values fall,
+		// returns the upper bound of the bin the percentile lands in.
+		double GetPercentile(double percentile) const
+		{
+			const uint64 total = GetTotalCount();
+			if (total == 0)
+				return 0.0;
+
+			const uint64 target = static_cast<uint64>(std::ceil(percentile * static_cast<double>(total)));
+			uint64 accumulated = 0;
+			for (uint32 i = 0; i < NumBins; ++i)
+			{
+				accumulated += GetBinCount(i);
+				if (accumulated >= target && accumulated > 0)
+					return i + 1 < NumBins ? GetBinLowerBound(i + 1) : mRangeMax;
+			}
+			return mRangeMax;
+		}
+
+	private:
+		uint32 GetBinIndex(double value) const
+		{
+			if (!(value > mRangeMin)) // also handles NaN
+				return 0;
+			if (value >= mRangeMax)
+				return NumBins - 1;
+
+			const double bin = mScale == EScale::Linear
+				? (value - mRangeMin) / (mRangeMax - mRangeMin) * NumBins
+				: std::log2(value / mRangeMin) * BinsPerOctave;
+
+			return std::min(static_cast<uint32>(bin), NumBins - 1);
+		}
+
+	private:
+		std::array<std::atomic<uint64>, NumBins> mBins{};
+		EScale mScale;
+		double mRangeMin;
+		double mRangeMax;
+	};
+
+	//==========================================================================
+	/// Measures timing of the engine's audio callbacks.
+	///
+	/// The audio thread calls BeginCallback/EndCallback around processing of each block,
+	/// which only does relaxed atomic stores. All of the getters can be called from any thread.
+	///
+	/// - Processing time: time spent processing the block.
+	/// - Load: processing time relative to the duration of the block (the deadline).
+	/// - Jitter: deviation of the interval between two callbacks from the duration of the previous block.
+	/// - Deadline misses: blocks that took longer to process than their duration, which is
+	///   likely to cause an xrun (audible crackles) on the device.
+	class CallbackProfiler
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		static constexpr uint32 cNumHistogramBins = 64;
+		using Histogram = AtomicHistogram<cNumHistogramBins>;
+
+		struct Snapshot
+		{
+			uint64 NumCallbacks = 0;
+			uint64 NumDeadlineMisses = 0;
+			double LastLoadPercent = 0.0;
+			double PeakLoadPercent = 0.0;
+			double AverageLoadPercent = 0.0;
+			double PeakProcessingTimeUs = 0.0;
+			double PeakJitterUs = 0.0;
+		};
+
+		CallbackProfiler() = default;
+
+		CallbackProfiler(const CallbackProfiler&) = delete;
+		CallbackProfiler& operator=(const CallbackProfiler&) = delete;
+
+		//======================================================================
+		/// Audio thread
+		void BeginCallback();
+		void EndCallback(uint32 numFrames, uint32 sampleRate);
+
+		//======================================================================
+		/// Any thread
+		Snapshot GetSnapshot() const;
+
+		// In microseconds, log2 scale from 1us to ~65ms
+		const Histogram& GetProcessingTimeHistogram() const { return mProcessingTimeUs; }
+		// In microseconds, log2 scale from 1us to ~65ms
+		const Histogram& GetJitterHistogram() const { return mJitterUs; }
+		// In percent, linear scale from 0 to 200%
+		const Histogram& GetLoadHistogram() const { return mLoadPercent; }
+
+		// Reset is deferred to the next callback to not race with the audio thread
+		void Reset() { mResetRequested.store(true, std::memory_order_release); }
+
+	private:
+		void ResetOnAudioThread();
+
+	private:
+		Histogram mProcessingTimeUs{ Histogram::EScale::Log2, 1.0, 65'536.0 };
+		Histogram mJitterUs{ Histogram::EScale::Log2, 1.0, 65'536.0 };
+		Histogram mLoadPercent{ Histogram::EScale::Linear, 0.0, 200.0 };
+
+		// Audio thread only
+		Clock::time_point mCallbackStart;
+		Clock::time_point mPreviousCallbackStart;
+		int64_t mPreviousBlockDurationNs = 0;
+
+		std::atomic<uint64> mNumCallbacks{ 0 };
+		std::atomic<uint64> mNumDeadlineMisses{ 0 };
+		std::atomic<uint64> mTotalProcessingNs{ 0 };
+		std::atomic<uint64> mTotalBlockDurationNs{ 0 };
+		std::atomic<uint64> mPeakProcessingNs{ 0 };
+		std::atomic<uint64> mPeakJitterNs{ 0 };
+		std::atomic<double> mLastLoadPercent{ 0.0 };
+		std::atomic<double> mPeakLoadPercent{ 0.0 };
+
+		std::atomic<bool> mResetRequested{ false };
+	};
+} // namespace JPL
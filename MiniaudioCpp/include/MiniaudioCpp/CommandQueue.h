@@ -0,0 +1,160 @@
+﻿//
+//      ██╗██████╗     ██╗     ██╗██████╗ ███████╗
+//      ██║██╔══██╗    ██║     ██║██╔══██╗██╔════╝		** MiniaudioCpp **
+//      ██║██████╔╝    ██║     ██║██████╔╝███████╗
+// ██   ██║██╔═══╝     ██║     ██║██╔══██╗╚════██║		https://github.com/Jaytheway/MiniaudioCpp
+// ╚█████╔╝██║         ███████╗██║██████╔╝███████║
+//  ╚════╝ ╚═╝         ╚══════╝╚═╝╚═════╝ ╚══════╝
+//
+//   Copyright 2024 Jaroslav Pevno, MiniaudioCpp is offered under the terms of the ISC license:
+//
+//   Permission to use, copy, modify, and/or distribute this software for any purpose with or
+//   without fee is hereby granted, provided that the above copyright notice and this permission
+//   notice appear in all copies. THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+//   WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+//   AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+//   CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+//   WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+//   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#pragma once
+
+#include "Core.h"
+#include "MiniaudioWrappers.h"
+
+#include <atomic>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace JPL
+{
+	//==========================================================================
+	/// Parameter change recorded on the game thread and applied on the audio thread
+	struct ParameterCommand
+	{
+		enum class EType : uint8
+		{
+			SoundVolume,
+			SoundPitch,
+			GroupPitch,
+			BusVolume,
+			LPFCutoff,
+			HPFCutoff,
+			SoundStart,
+			SoundStop
+		};
+
+		EType Type;
+		uint32 Index;	// Output bus index for BusVolume, filter order for LPF/HPF, fade length in frames for SoundStop
+		void* Target;	// ma_sound, ma_engine_node, ma_node_base, ma_lpf_node or ma_hpf_node
+		union
+		{
+			double Value;
+			uint64 Time;	// Engine time in frames for SoundStart/SoundStop
+		};
+
+		// Audio thread
+		void Apply() const;
+	};
+
+	//==========================================================================
+	/// Batch of parameter changes and scheduled starts and stops to be applied together at the start of an audio block.
+	///
+	/// Recording doesn't touch miniaudio objects, so it's not shared with the audio thread.
+	/// A batch is owned by a single thread, e.g. one per game thread, and can be reused
+	/// every frame without allocations once the capacity has grown.
+	///
+	/// Usage:
+	///		batch.SetVolume(sound, 0.5f);
+	///		batch.SetVolume(node.OutputBus(0), 0.2f);
+	///		batch.SetCutoffFrequency(lpf, 800.0);
+	///		engine.Submit(batch);
+	///
+	/// Nodes must stay alive until the batch is applied, i.e. until the start of the next audio block.
+	class CommandBatch
+	{
+	public:
+		CommandBatch() = default;
+		explicit CommandBatch(uint32 reserveCapacity) { mCommands.reserve(reserveCapacity); }
+
+		void SetVolume(Sound& sound, float volume);
+		void SetPitch(Sound& sound, float pitch);
+		void SetPitch(EngineNode& group, float pitch);
+		void SetVolume(OutputBus bus, float volume);
+
+		// Cached cutoff frequency of the wrapper is updated immediately,
+		// the filter itself is reinitialized on the audio thread.
+		void SetCutoffFrequency(LPFNode& lpf, double cutoffFrequency);
+		void SetCutoffFrequency(HPFNode& hpf, double cutoffFrequency);
+
+		// Schedule the sound to start or stop at the engine time, see Sound::StartAtFrame and Sound::StopAtFrame.
+		// All of the scheduling in the batch lands within the same audio block, so even if the time
+		// has already passed by then, sounds of the batch still start or stop together.
+		void ScheduleStart(Sound& sound, uint64 engineTimeInFrames);
+		void ScheduleStop(Sound& sound, uint64 engineTimeInFrames, uint32 fadeLengthInFrames = 0);
+
+		void Clear() { mCommands.clear(); }
+		bool IsEmpty() const { return mCommands.empty(); }
+		uint32 GetNumCommands() const { return static_cast<uint32>(mCommands.size()); }
+		std::span<const ParameterCommand> GetCommands() const { return mCommands; }
+
+	private:
+		std::vector<ParameterCommand> mCommands;
+	};
+
+	//==========================================================================
+	/// Bounded lock-free multi-producer single-consumer queue of parameter commands.
+	///
+	/// Producers reserve a contiguous range for the whole batch, write it, and then
+	/// commit ranges in the order they were reserved. The consumer only sees committed
+	/// ranges, so a batch is always applied as a whole within a single audio block.
+	///
+	/// The consumer never waits. A producer may briefly spin waiting for another producer
+	/// that reserved before it to commit, with a single producer it never does.
+	class CommandQueue
+	{
+	public:
+		// 'capacity' is rounded up to the next power of two
+		explicit CommandQueue(uint32 capacity);
+
+		CommandQueue(const CommandQueue&) = delete;
+		CommandQueue& operator=(const CommandQueue&) = delete;
+
+		// Any thread.
+		// Either all or none of the commands are pushed.
+		// @returns false if there is not enough space in the queue.
+		bool Push(std::span<const ParameterCommand> commands);
+
+		// Consumer thread.
+		// Call 'function' for each of the committed commands, in order.
+		// @returns number of commands consumed
+		template<class Function>
+		uint32 ConsumeAll(Function&& function);
+
+		uint32 GetCapacity() const { return static_cast<uint32>(mMask + 1); }
+
+	private:
+		std::unique_ptr<ParameterCommand[]> mCommands;
+		uint64 mMask;
+
+		alignas(JPL_CACHE_LINE_SIZE) std::atomic<uint64> mReserveIndex{ 0 };
+		alignas(JPL_CACHE_LINE_SIZE) std::atomic<uint64> mCommitIndex{ 0 };
+		alignas(JPL_CACHE_LINE_SIZE) std::atomic<uint64> mReadIndex{ 0 };
+	};
+
+	//==========================================================================
+	template<class Function>
+	inline uint32 CommandQueue::ConsumeAll(Function&& function)
+	{
+		const uint64 readIndex = mReadIndex.load(std::memory_order_relaxed);
+		const uint64 commitIndex = mCommitIndex.load(std::memory_order_acquire);
+
+		for (uint64 i = readIndex; i < commitIndex; ++i)
+			function(mCommands[i & mMask]);
+
+		// Release the space to the producers
+		mReadIndex.store(commitIndex, std::memory_order_release);
+		return static_cast<uint32>(commitIndex - readIndex);
+	}
+} // namespace JPL
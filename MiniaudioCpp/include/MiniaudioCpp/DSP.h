@@ -0,0 +1,86 @@
+﻿//
+//      ██╗██████╗     ██╗     ██╗██████╗ ███████╗
+//      ██║██╔══██╗    ██║     ██║██╔══██╗██╔════╝		** MiniaudioCpp **
+//      ██║██████╔╝    ██║     ██║██████╔╝███████╗
+// ██   ██║██╔═══╝     ██║     ██║██╔══██╗╚════██║		https://github.com/Jaytheway/MiniaudioCpp
+// ╚█████╔╝██║         ███████╗██║██████╔╝███████║
+//  ╚════╝ ╚═╝         ╚══════╝╚═╝╚═════╝ ╚══════╝
+//
+//   Copyright 2024 Jaroslav Pevno, MiniaudioCpp is offered under the terms of the ISC license:
+//
+//   Permission to use, copy, modify, and/or distribute this software for any purpose with or
+//   without fee is hereby granted, provided that the above copyright notice and this permission
+//   notice appear in all copies. THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+//   WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+//   AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+//   CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+//   WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+//   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#pragma once
+
+#include "Core.h"
+
+namespace JPL::DSP
+{
+	//==========================================================================
+	/// Vectorized kernels for the common buffer operations of custom nodes.
+	///
+	/// Kernels are compiled once per instruction set (SSE2, AVX2, AVX-512 on x86, NEON on ARM),
+	/// and the widest one supported by the host CPU is selected on first use,
+	/// so the library itself is built for the baseline of the target architecture.
+	///
+	/// All of them work on contiguous samples, interleaved buffers can be passed
+	/// as 'numFrames * numChannels' samples, except for the gain ramp, which steps per frame.
+	/// No alignment is required, source and destination must not overlap unless stated otherwise.
+
+	enum class EInstructionSet
+	{
+		Scalar,
+		SSE2,
+		AVX2,	// With FMA
+		AVX512,	// F, DQ and VL
+		NEON
+	};
+
+	// @returns true if the kernels were built for the instruction set, and the host CPU supports it
+	bool IsSupported(EInstructionSet instructionSet);
+
+	EInstructionSet GetInstructionSet();
+	const char* GetInstructionSetName();
+
+	// Override the selected kernels, e.g. to compare the results or performance of different instruction sets.
+	// Not synchronized with kernels running on other threads, they may use either set for the current call.
+	// @returns false if the instruction set is not supported
+	bool SetInstructionSet(EInstructionSet instructionSet);
+
+	// Go back to the widest supported instruction set
+	void ResetInstructionSet();
+
+	void Copy(const float* source, float* destination, uint32 numSamples);
+	void Silence(float* destination, uint32 numSamples);
+
+	// destination += source
+	void Mix(const float* source, float* destination, uint32 numSamples);
+
+	// destination += source * gain
+	void MixWithGain(const float* source, float* destination, uint32 numSamples, float gain);
+
+	// In place, samples *= gain
+	void ApplyGain(float* samples, uint32 numSamples, float gain);
+
+	// In place, gain goes linearly from 'startGain' at the first frame towards 'endGain',
+	// which is reached one frame past the end, so that consecutive blocks join without a step.
+	void ApplyGainRamp(float* samples, uint32 numChannels, uint32 numFrames, float startGain, float endGain);
+
+	// In place
+	void Clamp(float* samples, uint32 numSamples, float minValue, float maxValue);
+
+	// @returns largest absolute sample value, 0 if there are no samples
+	float FindPeak(const float* samples, uint32 numSamples);
+
+	// Conversion between interleaved frames and planar (one contiguous buffer per channel) samples.
+	// Mono is a copy, stereo is vectorized, other channel counts fall back to a scalar loop.
+	void Deinterleave(const float* interleaved, float* const* channels, uint32 numChannels, uint32 numFrames);
+	void Interleave(const float* const* channels, float* interleaved, uint32 numChannels, uint32 numFrames);
+} // namespace JPL::DSP
@@ -0,0 +1,123 @@
+﻿//
+//      ██╗██████╗     ██╗     ██╗██████╗ ███████╗
+//      ██║██╔══██╗    ██║     ██║██╔══██╗██╔════╝		** MiniaudioCpp **
+//      ██║██████╔╝    ██║     ██║██████╔╝███████╗
+// ██   ██║██╔═══╝     ██║     ██║██╔══██╗╚════██║		https://github.com/Jaytheway/MiniaudioCpp
+// ╚█████╔╝██║         ███████╗██║██████╔╝███████║
+//  ╚════╝ ╚═╝         ╚══════╝╚═╝╚═════╝ ╚══════╝
+//
+//   Copyright 2024 Jaroslav Pevno, MiniaudioCpp is offered under the terms of the ISC license:
+//
+//   Permission to use, copy, modify, and/or distribute this software for any purpose with or
+//   without fee is hereby granted, provided that the above copyright notice and this permission
+//   notice appear in all copies. THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+//   WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+//   AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+//   CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+//   WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+//   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#pragma once
+
+#include "Core.h"
+
+#if defined(JPL_CPU_X86)
+#include <xmmintrin.h>
+#elif defined(JPL_CPU_ARM) && defined(JPL_COMPILER_MSVC)
+#include <float.h>
+#endif
+
+namespace JPL
+{
+	//==========================================================================
+	/// Flushes denormal floats to zero on the calling thread for the lifetime of the scope,
+	/// and restores the previous mode of the thread afterwards.
+	///
+	/// Recursive filters and feedback loops decay into denormal range, where each operation
+	/// can be orders of magnitude slower on x86. Inaudible at these levels, so it's safe to flush them.
+	///
+	/// x86 sets FTZ and DAZ bits of MXCSR, ARM sets FZ bit of FPCR/FPSCR.
+	/// On other architectures this does nothing.
+	///
+	/// If the thread already flushes denormals (e.g. a node processed within the engine's scope),
+	/// the control register is only read, not written.
+	class ScopedFlushDenormals
+	{
+	public:
+		JPL_INLINE explicit ScopedFlushDenormals(bool bEnable = true)
+		{
+			if (!bEnable)
+				return;
+
+			// Also true where it's not supported, the mask being empty
+			const ControlWord previous = Read();
+			if ((previous & FLUSH_MASK) == FLUSH_MASK)
+				return;
+
+			mPrevious = previous;
+			bRestore = true;
+			Write(previous | FLUSH_MASK);
+		}
+
+		JPL_INLINE ~ScopedFlushDenormals()
+		{
+			if (bRestore)
+				Write(mPrevious);
+		}
+
+		ScopedFlushDenormals(const ScopedFlushDenormals&) = delete;
+		ScopedFlushDenormals& operator=(const ScopedFlushDenormals&) = delete;
+
+		static constexpr bool IsSupported()
+		{
+#if defined(JPL_CPU_X86) || defined(JPL_CPU_ARM)
+			return true;
+#else
+			return false;
+#endif
+		}
+
+		// @returns true if the calling thread currently flushes denormals
+		static bool IsEnabled()
+		{
+			return FLUSH_MASK != 0 && (Read() & FLUSH_MASK) == FLUSH_MASK;
+		}
+
+	private:
+#if defined(JPL_CPU_X86)
+		using ControlWord = uint32;
+		static constexpr ControlWord FLUSH_MASK = 0x8040;	// FTZ | DAZ
+
+		JPL_INLINE static ControlWord Read() { return _mm_getcsr(); }
+		JPL_INLINE static void Write(ControlWord value) { _mm_setcsr(value); }
+#elif defined(JPL_CPU_ARM) && defined(JPL_COMPILER_MSVC)
+		using ControlWord = unsigned int;
+		static constexpr ControlWord FLUSH_MASK = _DN_FLUSH;
+
+		JPL_INLINE static ControlWord Read() { return _controlfp(0, 0) & _MCW_DN; }
+		JPL_INLINE static void Write(ControlWord value) { _controlfp(value, _MCW_DN); }
+#elif defined(JPL_CPU_ARM) && JPL_CPU_ADDRESS_BITS == 64
+		using ControlWord = uint64;
+		static constexpr ControlWord FLUSH_MASK = ControlWord(1) << 24;	// FPCR.FZ
+
+		JPL_INLINE static ControlWord Read() { ControlWord value; __asm__ volatile("mrs %0, fpcr" : "=r"(value)); return value; }
+		JPL_INLINE static void Write(ControlWord value) { __asm__ volatile("msr fpcr, %0" : : "r"(value)); }
+#elif defined(JPL_CPU_ARM)
+		using ControlWord = uint32;
+		static constexpr ControlWord FLUSH_MASK = ControlWord(1) << 24;	// FPSCR.FZ
+
+		JPL_INLINE static ControlWord Read() { ControlWord value; __asm__ volatile("vmrs %0, fpscr" : "=r"(value)); return value; }
+		JPL_INLINE static void Write(ControlWord value) { __asm__ volatile("vmsr fpscr, %0" : : "r"(value)); }
+#else
+		using ControlWord = uint32;
+		static constexpr ControlWord FLUSH_MASK = 0;
+
+		JPL_INLINE static ControlWord Read() { return 0; }
+		JPL_INLINE static void Write(ControlWord) {}
+#endif
+
+	private:
+		ControlWord mPrevious = 0;
+		bool bRestore = false;
+	};
+} // namespace JPL
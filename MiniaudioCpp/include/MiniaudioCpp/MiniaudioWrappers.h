@@ -26,10 +26,19 @@
 #define MA_DEFAULT_NODE_CACHE_CAP_IN_FRAMES_PER_BUS 480
 #endif
 #include "NodeTraits.h"
+#include "NodeProfiler.h"
+#include "DSP.h"
+#include "FPFlushDenormals.h"
 
 #include "choc/containers/choc_SmallVector.h"
 #include "choc/audio/choc_SampleBuffers.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
 #include <span>
 
 //==============================================================================
@@ -44,36 +53,154 @@ namespace JPL
 {
 	//==========================================================================
 	/// Forward declaration
-	template<class TNode>
+	struct DynamicLayout;
+	template<class TNode, class TLayout = DynamicLayout>
 	struct TBaseNode;
 	struct Engine;
+	class CallbackProfiler;
+	class CommandBatch;
+
+	namespace Internal
+	{
+		struct EngineContext;
+		struct AsyncLoadState;
+	}
 
 	//==========================================================================
-	/// These must be set by the client
+	/// These must be set by the client.
+	/// GetMiniaudioEngine is used by the wrappers that are initialized without explicit Engine.
+	/// gEngineAllocationCallbacks are used to init and uninit nodes, and engines without explicit callbacks,
+	/// so they must not change while any of those are alive. nullptr - use miniaudio's default, see also PoolAllocator.
 	using GetMiniaudioEngineFunction = MA::Engine& (*)(void* context);
 	JPL_EXPORT extern GetMiniaudioEngineFunction GetMiniaudioEngine;
 	JPL_EXPORT extern ma_allocation_callbacks* gEngineAllocationCallbacks;
 
 
 	//==========================================================================
-	class ProcessCallbackData
+	/// Bus layout of a custom node, see TBaseNode.
+	///
+	/// DynamicLayout - bus and channel counts are set at runtime by NodeLayout,
+	/// and queried from the node when processing.
+	///
+	/// FixedLayout - bus and channel counts are compile-time constants,
+	/// so the buffer views are built without calling into miniaudio,
+	/// and per-channel loops can be unrolled. E.g. stereo in, stereo out:
+	///		TBaseNode<MyNode, FixedLayout<Buses<2>, Buses<2>>>
+	///
+	/// PlanarLayout - FixedLayout with one contiguous buffer per channel.
+	/// Inputs are deinterleaved into scratch memory of the node before Process,
+	/// and outputs are interleaved back after it, so that the node can run
+	/// per-channel kernels (filters, delays) over contiguous samples.
+	/// Blocks longer than PLANAR_BLOCK_SIZE are processed in several calls.
+	struct DynamicLayout
+	{
+		static constexpr bool IS_FIXED = false;
+		static constexpr bool IS_PLANAR = false;
+	};
+
+	enum class EBufferLayout
+	{
+		Interleaved,
+		Planar
+	};
+
+	template<uint32_t... NumChannels>
+	struct Buses {};
+
+	namespace Internal
+	{
+		// @returns index of the first channel of each bus, if the channels of all busses were in a single array
+		template<size_t N>
+		constexpr std::array<uint32_t, N> GetChannelOffsets(const std::array<uint32_t, N>& channels)
+		{
+			std::array<uint32_t, N> offsets{};
+			for (uint32_t i = 1; i < N; ++i)
+				offsets[i] = offsets[i - 1] + channels[i - 1];
+			return offsets;
+		}
+
+		// @returns true if each input bus has the same number of channels as the output bus it's paired with
+		template<class TInputs, class TOutputs>
+		constexpr bool HasMatchingInPlaceBuses(const TInputs& inputs, const TOutputs& outputs)
+		{
+			for (size_t i = 0; i < std::min(std::size(inputs), std::size(outputs)); ++i)
+			{
+				if (inputs[i] != outputs[i])
+					return false;
+			}
+			return true;
+		}
+	}
+
+	template<class TInputs, class TOutputs, EBufferLayout BufferLayout = EBufferLayout::Interleaved>
+	struct FixedLayout;
+
+	template<class TInputs, class TOutputs>
+	using PlanarLayout = FixedLayout<TInputs, TOutputs, EBufferLayout::Planar>;
+
+	template<uint32_t... NumInputChannels, uint32_t... NumOutputChannels, EBufferLayout BufferLayout>
+	struct FixedLayout<Buses<NumInputChannels...>, Buses<NumOutputChannels...>, BufferLayout>
+	{
+		static constexpr bool IS_FIXED = true;
+		static constexpr bool IS_PLANAR = BufferLayout == EBufferLayout::Planar;
+
+		// Max number of frames passed to Process of a planar node
+		static constexpr uint32_t PLANAR_BLOCK_SIZE = 256;
+
+		static constexpr uint32_t NUM_INPUT_BUSES = sizeof...(NumInputChannels);
+		static constexpr uint32_t NUM_OUTPUT_BUSES = sizeof...(NumOutputChannels);
+
+		static constexpr std::array<uint32_t, NUM_INPUT_BUSES> INPUT_CHANNELS{ NumInputChannels... };
+		static constexpr std::array<uint32_t, NUM_OUTPUT_BUSES> OUTPUT_CHANNELS{ NumOutputChannels... };
+
+		// Total across all busses
+		static constexpr uint32_t NUM_INPUT_CHANNELS = (0u + ... + NumInputChannels);
+		static constexpr uint32_t NUM_OUTPUT_CHANNELS = (0u + ... + NumOutputChannels);
+
+		// Index of the first channel of each bus in the planar scratch
+		static constexpr std::array<uint32_t, NUM_INPUT_BUSES> INPUT_CHANNEL_OFFSETS = Internal::GetChannelOffsets(INPUT_CHANNELS);
+		static constexpr std::array<uint32_t, NUM_OUTPUT_BUSES> OUTPUT_CHANNEL_OFFSETS = Internal::GetChannelOffsets(OUTPUT_CHANNELS);
+
+		static_assert(NUM_INPUT_BUSES <= MA_MAX_NODE_BUS_COUNT && NUM_OUTPUT_BUSES <= MA_MAX_NODE_BUS_COUNT, "Too many busses.");
+		static_assert(((NumInputChannels > 0) && ...) && ((NumOutputChannels > 0) && ...), "Bus must have at least one channel.");
+	};
+
+	namespace Internal
+	{
+		template<class TLayout>
+		struct BusCounts
+		{
+			static constexpr uint32_t InputBusCount = TLayout::NUM_INPUT_BUSES;
+			static constexpr uint32_t OutputBusCount = TLayout::NUM_OUTPUT_BUSES;
+		};
+
+		template<>
+		struct BusCounts<DynamicLayout>
+		{
+			const uint32_t InputBusCount;
+			const uint32_t OutputBusCount;
+		};
+	}
+
+	//==========================================================================
+	template<class TLayout>
+	class TProcessCallbackData : public Internal::BusCounts<TLayout>
 	{
 	private:
-		ProcessCallbackData() = delete;
+		TProcessCallbackData() = delete;
 
-		template<class TNode>
+		template<class TNode, class TNodeLayout>
 		friend struct MA::TBaseNode;
 		// ..add more friends if need to construct ProcessCallbackData
 
-		ProcessCallbackData(const uint32_t& InputBusCount,
-							const uint32_t& OutputBusCount,
-							ma_node_base* nodeBase,
-							const float** ppFramesIn,
-							ma_uint32* pFrameCountIn,
-							float** ppFramesOut,
-							ma_uint32* pFrameCountOut)
-			: InputBusCount(InputBusCount)
-			, OutputBusCount(OutputBusCount)
+		TProcessCallbackData(const uint32_t& InputBusCount,
+							 const uint32_t& OutputBusCount,
+							 ma_node_base* nodeBase,
+							 const float** ppFramesIn,
+							 ma_uint32* pFrameCountIn,
+							 float** ppFramesOut,
+							 ma_uint32* pFrameCountOut) requires (!TLayout::IS_FIXED)
+			: Internal::BusCounts<TLayout>{ InputBusCount, OutputBusCount }
 			, nodeBase(nodeBase)
 			, ppFramesIn(ppFramesIn)
 			, pFrameCountIn(pFrameCountIn)
@@ -82,47 +209,114 @@ namespace JPL
 		{
 		}
 
+		// With planar layout 'ppFramesIn' and 'ppFramesOut' are arrays of all of the input and output channels
+		TProcessCallbackData(ma_node_base* nodeBase,
+							 const float* const* ppFramesIn,
+							 ma_uint32* pFrameCountIn,
+							 float* const* ppFramesOut,
+							 ma_uint32* pFrameCountOut) requires (TLayout::IS_FIXED)
+			: nodeBase(nodeBase)
+			, ppFramesIn(ppFramesIn)
+			, pFrameCountIn(pFrameCountIn)
+			, ppFramesOut(ppFramesOut)
+			, pFrameCountOut(pFrameCountOut)
+		{
+		}
+
 	public:
-		using InputBuffer = choc::buffer::InterleavedView<const float>;
-		using OutputBuffer = choc::buffer::InterleavedView<float>;
+		static constexpr bool IS_PLANAR = TLayout::IS_PLANAR;
+
+		using InputBuffer = std::conditional_t<IS_PLANAR, choc::buffer::ChannelArrayView<const float>, choc::buffer::InterleavedView<const float>>;
+		using OutputBuffer = std::conditional_t<IS_PLANAR, choc::buffer::ChannelArrayView<float>, choc::buffer::InterleavedView<float>>;
+
+		JPL_INLINE uint32_t GetNumInputChannels(uint32_t busIndex) const
+		{
+			if constexpr (TLayout::IS_FIXED)
+				return TLayout::INPUT_CHANNELS[busIndex];
+			else
+				return MA::InputBusIndex(busIndex).Of(nodeBase).GetNumChannels();
+		}
+
+		JPL_INLINE uint32_t GetNumOutputChannels(uint32_t busIndex) const
+		{
+			if constexpr (TLayout::IS_FIXED)
+				return TLayout::OUTPUT_CHANNELS[busIndex];
+			else
+				return MA::OutputBusIndex(busIndex).Of(nodeBase).GetNumChannels();
+		}
 
 		InputBuffer GetInputBuffer(uint32_t busIndex)
 		{
 			// Not checking for NULL input, making it caller's responsibility to allow it with node FLAGS
-			const uint32_t numChannels = MA::InputBusIndex(busIndex).Of(nodeBase).GetNumChannels();
-			return choc::buffer::createInterleavedView(ppFramesIn[busIndex], numChannels, *pFrameCountIn);
+			if constexpr (IS_PLANAR)
+				return choc::buffer::createChannelArrayView(ppFramesIn + TLayout::INPUT_CHANNEL_OFFSETS[busIndex], GetNumInputChannels(busIndex), *pFrameCountIn);
+			else
+				return choc::buffer::createInterleavedView(ppFramesIn[busIndex], GetNumInputChannels(busIndex), *pFrameCountIn);
 		}
 
 		OutputBuffer GetOutputBuffer(uint32_t busIndex)
 		{
-			const uint32_t numChannels = MA::OutputBusIndex(busIndex).Of(nodeBase).GetNumChannels();
-			return choc::buffer::createInterleavedView(ppFramesOut[busIndex], numChannels, *pFrameCountIn);
+			if constexpr (IS_PLANAR)
+				return choc::buffer::createChannelArrayView(ppFramesOut + TLayout::OUTPUT_CHANNEL_OFFSETS[busIndex], GetNumOutputChannels(busIndex), *pFrameCountOut);
+			else
+				return choc::buffer::createInterleavedView(ppFramesOut[busIndex], GetNumOutputChannels(busIndex), *pFrameCountOut);
 		}
 
-		const uint32_t InputBusCount;
-		const uint32_t OutputBusCount;
+		// For IN_PLACE nodes, output buffer of the bus that already holds its input, to be modified in place
+		JPL_INLINE OutputBuffer GetInPlaceBuffer(uint32_t busIndex) { return GetOutputBuffer(busIndex); }
 
 		JPL_INLINE bool IsNullInput() const { return ppFramesIn == nullptr; }
 
 		JPL_INLINE uint32_t GetInputFrameCount() const { return *pFrameCountIn; }
 		JPL_INLINE uint32_t GetOutputFrameCount() const { return *pFrameCountOut; }
 
+		// Nodes with MA_NODE_FLAG_DIFFERENT_PROCESSING_RATES must report how many input frames
+		// they've consumed and how many output frames they've produced, once done processing.
+		// Input frames that are not consumed are passed in again on the next call.
+		// Buffers retrieved afterwards are sized to the new frame counts.
+		JPL_INLINE void SetInputFrameCount(uint32_t numFramesConsumed)
+		{
+			JPL_ASSERT(numFramesConsumed <= *pFrameCountIn, "Node can't consume more input frames than it's given.");
+			*pFrameCountIn = numFramesConsumed;
+		}
+
+		JPL_INLINE void SetOutputFrameCount(uint32_t numFramesProduced)
+		{
+			JPL_ASSERT(numFramesProduced <= *pFrameCountOut, "Node can't produce more output frames than it's asked for.");
+			*pFrameCountOut = numFramesProduced;
+		}
+
 		JPL_INLINE void FillOutputBusWithSilence(uint32_t outputBusIndex)
 		{
 			const auto outputBuffer = GetOutputBuffer(outputBusIndex);
-			ma_silence_pcm_frames(outputBuffer.data.data, outputBuffer.getNumFrames(), ma_format_f32, outputBuffer.getNumChannels());
+			if constexpr (IS_PLANAR)
+			{
+				for (uint32_t channel = 0; channel < outputBuffer.getNumChannels(); ++channel)
+					DSP::Silence(outputBuffer.data.channels[channel] + outputBuffer.data.offset, outputBuffer.getNumFrames());
+			}
+			else
+			{
+				DSP::Silence(outputBuffer.data.data, outputBuffer.getNumFrames() * outputBuffer.getNumChannels());
+			}
 		}
 
 		void FillOutputWithSilence()
 		{
-			for (uint32_t i = 0; i < OutputBusCount; ++i)
+			for (uint32_t i = 0; i < this->OutputBusCount; ++i)
 				FillOutputBusWithSilence(i);
 		}
 
 		void CopyInputsToOutputs()
 		{
-			for (uint32_t i = 0; i < std::min(InputBusCount, OutputBusCount); ++i)
+			for (uint32_t i = 0; i < std::min(this->InputBusCount, this->OutputBusCount); ++i)
 			{
+				// Graph may have handed us the same buffer for input and output
+				if constexpr (!IS_PLANAR)
+				{
+					if (ppFramesIn[i] == ppFramesOut[i])
+						continue;
+				}
+
 				const auto inputBuffer = GetInputBuffer(i);
 				const auto outputBuffer = GetOutputBuffer(i);
 
@@ -131,18 +325,28 @@ namespace JPL
 				const uint32_t numFramesToCopy = std::min(inputBuffer.getNumFrames(), outputBuffer.getNumFrames());
 				const uint32_t numChannels = std::min(inputBuffer.getNumChannels(), outputBuffer.getNumChannels());
 
-				memcpy(outputBuffer.data.data, inputBuffer.data.data, sizeof(InputBuffer::Sample) * numFramesToCopy * numChannels);
+				if constexpr (IS_PLANAR)
+				{
+					for (uint32_t channel = 0; channel < numChannels; ++channel)
+						DSP::Copy(inputBuffer.data.channels[channel] + inputBuffer.data.offset, outputBuffer.data.channels[channel] + outputBuffer.data.offset, numFramesToCopy);
+				}
+				else
+				{
+					DSP::Copy(inputBuffer.data.data, outputBuffer.data.data, numFramesToCopy * numChannels);
+				}
 			}
 		}
 
 	private:
 		ma_node_base* nodeBase;
-		const float** ppFramesIn;
+		const float* const* ppFramesIn;
 		ma_uint32* pFrameCountIn;
-		float** ppFramesOut;
+		float* const* ppFramesOut;
 		ma_uint32* pFrameCountOut;
 	};
 
+	using ProcessCallbackData = TProcessCallbackData<DynamicLayout>;
+
 	//==========================================================================
 	using OnProcessCb = void(*)(ma_node* pNode, const float** ppFramesIn, ma_uint32* pFrameCountIn, float** ppFramesOut, ma_uint32* pFrameCountOut);
 	using OnGetRequiredInputFrameCountCb = ma_result(*)(ma_node* pNode, ma_uint32 outputFrameCount, ma_uint32* pInputFrameCount);
@@ -176,8 +380,12 @@ namespace JPL
 		inline NodeLayout& WithOutputs(uint32_t outputChannels) { return WithOutputs({ outputChannels }); }
 
 		NodeLayout& WithBusConfig(const BusConfig& busConfig) { BusConfig = busConfig; return *this; }
+
+		// Engine to create the node in, if not set, GetMiniaudioEngine is used
+		NodeLayout& WithEngine(MA::Engine& engine) { Engine = &engine; return *this; }
 		
 		BusConfig BusConfig;
+		MA::Engine* Engine = nullptr;
 	};
 
 	//==========================================================================
@@ -189,6 +397,11 @@ namespace JPL
 		template<class T> concept CCanLoop = requires(T ds) { { ds.SetLooping(true) } -> std::same_as<void>; };
 		template<class T> concept CHasChannelMap = requires(T ds) { { ds.GetChannelMap(std::declval<std::span<ma_channel>>()) } -> std::same_as<void>; };
 
+		template<class T> concept CIsInPlace = requires { { T::IN_PLACE } -> std::convertible_to<bool>; } && T::IN_PLACE;
+		template<class T> concept CHasTailLength = requires(const T node) { { node.GetTailLengthInFrames() } -> std::same_as<uint32_t>; };
+		template<class T> concept CKeepsDenormals = requires { { T::FLUSH_DENORMALS } -> std::convertible_to<bool>; } && !T::FLUSH_DENORMALS;
+		template<class T> concept CHasRequiredInputFrameCount = requires(T node, uint32_t outputFrameCount) { { node.GetRequiredInputFrameCount(outputFrameCount) } -> std::same_as<uint32_t>; };
+
 		template<class T>
 		concept CDataSource = requires(T ds)
 		{
@@ -245,11 +458,87 @@ namespace JPL
 	//==========================================================================
 	struct Engine : Traits::EngineNodeTraits<Internal::Engine>
 	{
+		struct EngineSettings
+		{
+			uint32_t NumChannels = 0;	// 0 - use device channel count (or 2 in offline mode)
+			uint32_t SampleRate = 0;	// 0 - use device sample rate (or 48kHz in offline mode)
+			ma_vfs* VFS = nullptr;		// Ignored if ResourceManager is set
+
+			// Resource manager to share with another engine, must outlive this engine.
+			// nullptr - the engine creates and owns its own resource manager.
+			ma_resource_manager* ResourceManager = nullptr;
+
+			// Allocator for the engine and everything it owns, e.g. resource manager and sounds.
+			// Copied on Init. nullptr - use gEngineAllocationCallbacks, or miniaudio's default if that's not set either.
+			const ma_allocation_callbacks* AllocationCallbacks = nullptr;
+
+			// Size of the block the node graph is processed in, as well as the device period.
+			// Small blocks (e.g. 64 or 128 frames) reduce latency at the cost of higher CPU overhead.
+			// 0 - use miniaudio defaults (device period, and MA_DEFAULT_NODE_CACHE_CAP_IN_FRAMES_PER_BUS for node caches)
+			uint32_t PeriodSizeInFrames = 0;
+
+			// Don't open playback device, the graph is only processed by calling Render.
+			// Useful to render faster than realtime, or on machines without audio device.
+			bool Offline = false;
+
+			// Measure timing of each audio callback, see GetProfiler.
+			// In offline mode each call to Render is measured as a callback.
+			bool EnableProfiling = false;
+
+			// Flush denormal floats to zero while the node graph is processed, see ScopedFlushDenormals.
+			// The previous mode of the audio thread is restored after each block.
+			bool FlushDenormals = true;
+
+			// Max number of parameter commands waiting to be applied by the audio thread, see Submit.
+			// Rounded up to a power of two. 0 - don't create command queue.
+			uint32_t CommandQueueCapacity = 1024;
+		};
+
+		Engine();
+		~Engine();
+		Engine(Engine&&) noexcept;
+		Engine& operator=(Engine&&) noexcept;
+
+		bool Init(const EngineSettings& settings);
 		bool Init(uint32_t numChannels, ma_vfs* vfs);
+
 		uint32_t GetSampleRate() const;
 		inline double GetSampleRateDouble() const { return static_cast<double>(GetSampleRate()); }
+		uint32_t GetNumChannels() const;
 		uint32_t GetProcessingSizeInFrames() const;
 		InputBus GetEndpointBus();
+
+		// Absolute engine time, the clock sounds are scheduled against.
+		// Advances by the number of frames processed by the node graph.
+		uint64_t GetTimeInFrames() const;
+		uint64_t GetTimeInMilliseconds() const;
+
+		bool IsOffline() const;
+
+		// Pull next 'numFrames' of interleaved f32 frames from the node graph.
+		// Only valid for engines initialized in offline mode.
+		// @returns number of frames rendered, which is less than 'numFrames'
+		// if 'output' doesn't have space for 'numFrames * GetNumChannels()' samples.
+		uint64_t Render(std::span<float> output, uint64_t numFrames);
+
+		// Render next 'numFrames' to a 32-bit float WAV file.
+		// Only valid for engines initialized in offline mode.
+		// @returns false if the file couldn't be written, or the engine stopped rendering frames.
+		bool RenderToFile(const char* filePath, uint64_t numFrames);
+
+		// Queue the batch of parameter changes to be applied at the start of the next audio block.
+		// Safe to call from multiple threads. The batch is cleared if it was queued.
+		// @returns false if the engine has no command queue or there is not enough space in the queue
+		bool Submit(CommandBatch& batch);
+
+		// Stats of the audio callbacks, safe to read from any thread.
+		// @returns nullptr if the engine was not initialized with EnableProfiling
+		const CallbackProfiler* GetProfiler() const;
+		CallbackProfiler* GetProfiler();
+
+	private:
+		// State used by the audio callback, must outlive the ma_engine
+		std::unique_ptr<Internal::EngineContext> mContext;
 	};
 
 	//==========================================================================
@@ -259,23 +548,127 @@ namespace JPL
 		BaseNode() = delete;
 
 	private:
-		template<class TNode>
+		template<class TNode, class TLayout>
 		friend struct TBaseNode;
 		//friend bool TBaseNode<TNode>::Init(const NodeLayout& nodeLayout, bool initStarted);
 		static ma_node_config InitConfig(const NodeLayout& nodeLayout, bool initStarted = true);
 	};
 
+	namespace Internal
+	{
+		//======================================================================
+		/// Per-channel buffers of a node with planar layout
+		template<class TLayout>
+		struct TPlanarScratch {};
+
+		template<class TLayout> requires (TLayout::IS_PLANAR)
+		struct TPlanarScratch<TLayout>
+		{
+			static constexpr uint32_t NUM_INPUTS = std::max(TLayout::NUM_INPUT_CHANNELS, 1u);
+			static constexpr uint32_t NUM_OUTPUTS = std::max(TLayout::NUM_OUTPUT_CHANNELS, 1u);
+
+			alignas(JPL_CACHE_LINE_SIZE) float Inputs[NUM_INPUTS][TLayout::PLANAR_BLOCK_SIZE];
+			alignas(JPL_CACHE_LINE_SIZE) float Outputs[NUM_OUTPUTS][TLayout::PLANAR_BLOCK_SIZE];
+		};
+
+		//======================================================================
+		/// Input silence tracking of the nodes that can sleep, see TBaseNode::SLEEPS_ON_SILENCE
+		template<bool bEnabled>
+		struct TSleepState
+		{
+		};
+
+		template<>
+		struct TSleepState<true>
+		{
+			uint32_t NumSilentFrames = 0;			// Consecutive frames of silent input, stops counting past the tail
+			std::atomic<bool> bSleeping{ false };	// Written by the audio thread
+		};
+
+		//======================================================================
+		/// Memory of a custom node allocated by TBaseNode,
+		/// extends user's TNode with the state maintained by the wrapper.
+		template<class TNode, class TLayout>
+		struct TNodeStorage : TNode
+		{
+#if defined(JPL_ENABLE_NODE_PROFILING)
+			NodeProfiler::Entry ProfilerEntry{ GetTypeName<TNode>(), this };
+#endif
+			[[no_unique_address]] TPlanarScratch<TLayout> PlanarScratch;
+			[[no_unique_address]] TSleepState<JPL::impl::CHasTailLength<TNode>> SleepState;
+		};
+
+		template<class TNode, class TLayout>
+		using TCustomNode = TNodeBase<TNodeStorage<TNode, TLayout>>;
+	}
+
 	//==========================================================================
-	template<class TNode>
-	struct TBaseNode : Traits::NodeDefaultTraits<Internal::TNodeBase<TNode>>
+	/// Custom node, TNode must define FLAGS and Process(TProcessCallbackData<TLayout>&).
+	/// With FixedLayout the bus configuration is known at compile time,
+	/// and the node can be initialized without NodeLayout.
+	template<class TNode, class TLayout>
+	struct TBaseNode : Traits::NodeDefaultTraits<Internal::TCustomNode<TNode, TLayout>>
 	{
-		TRAIT_DEFS(Internal::TNodeBase<TNode>);
+		using InternalNode = Internal::TCustomNode<TNode, TLayout>;
+		TRAIT_DEFS(InternalNode);
+
+		using CallbackData = TProcessCallbackData<TLayout>;
 
 		static constexpr bool IS_PASSTHROUGH = (TNode::FLAGS & MA_NODE_FLAG_PASSTHROUGH) != 0;
+		static constexpr bool IS_FIXED_LAYOUT = TLayout::IS_FIXED;
+		static constexpr bool IS_PLANAR = TLayout::IS_PLANAR;
+
+		// Variable rate nodes (resamplers, decimators, time-stretchers) consume and produce different numbers
+		// of frames, see ProcessCallbackData::SetInputFrameCount and SetOutputFrameCount.
+		// They can implement 'uint32_t GetRequiredInputFrameCount(uint32_t outputFrameCount)' to tell the graph
+		// how many input frames to pull for the requested output, otherwise the same number is pulled.
+		static constexpr bool HAS_DIFFERENT_PROCESSING_RATES = (TNode::FLAGS & MA_NODE_FLAG_DIFFERENT_PROCESSING_RATES) != 0;
+		static constexpr bool HAS_REQUIRED_INPUT_FRAME_COUNT = impl::CHasRequiredInputFrameCount<TNode>;
+
+		static_assert(!HAS_REQUIRED_INPUT_FRAME_COUNT || HAS_DIFFERENT_PROCESSING_RATES,
+					  "GetRequiredInputFrameCount is only used by nodes with MA_NODE_FLAG_DIFFERENT_PROCESSING_RATES.");
+
+		static_assert(!IS_PLANAR || !HAS_DIFFERENT_PROCESSING_RATES,
+					  "Planar node is processed in blocks of the same number of input and output frames.");
+
+		// In place nodes define 'static constexpr bool IN_PLACE = true' and process each input bus
+		// directly in the output bus it's paired with, see ProcessCallbackData::GetInPlaceBuffer.
+		// Input is copied to the output before Process, unless the graph already uses the same buffer for both.
+		static constexpr bool IS_IN_PLACE = impl::CIsInPlace<TNode>;
+
+		static_assert(!IS_IN_PLACE || !HAS_DIFFERENT_PROCESSING_RATES,
+					  "In place node must consume and produce the same number of frames.");
+		static_assert(!IS_IN_PLACE || !IS_PLANAR,
+					  "Planar node is already processed in its own scratch buffers.");
+
+		// Nodes implementing 'uint32_t GetTailLengthInFrames() const' (e.g. 0 for a gain, decay time for a reverb)
+		// go to sleep once all of their inputs have been digital silence for longer than the tail.
+		// While sleeping, Process is not called and the outputs are filled with silence,
+		// until any of the inputs is not silent anymore.
+		static constexpr bool SLEEPS_ON_SILENCE = impl::CHasTailLength<TNode>;
+
+		static_assert(!SLEEPS_ON_SILENCE || !HAS_DIFFERENT_PROCESSING_RATES,
+					  "Variable rate node can't sleep, it must report consumed input frames.");
+
+		// Denormals are flushed to zero while the node is processed, in case its graph is not processed by the Engine,
+		// unless the node defines 'static constexpr bool FLUSH_DENORMALS = false'.
+		// Within the Engine's scope (see EngineSettings::FlushDenormals) this only reads the control register.
+		static constexpr bool FLUSHES_DENORMALS = !impl::CKeepsDenormals<TNode>;
 
 		bool Init(const NodeLayout& nodeLayout, bool initStarted = true)
 		{
-			if constexpr (IS_PASSTHROUGH)
+			if constexpr (IS_FIXED_LAYOUT)
+			{
+				static_assert(!IS_PASSTHROUGH || (TLayout::NUM_INPUT_BUSES == 1 && TLayout::NUM_OUTPUT_BUSES == 1),
+							  "Passthrough node can only have single Input and Output bus configuration.");
+
+				static_assert(!IS_IN_PLACE || Internal::HasMatchingInPlaceBuses(TLayout::INPUT_CHANNELS, TLayout::OUTPUT_CHANNELS),
+							  "In place node must have the same number of channels on paired Input and Output busses.");
+
+				if (!JPL_ENSURE(MatchesLayout(nodeLayout.BusConfig), "NodeLayout doesn't match the fixed layout of the node."))
+					return false;
+			}
+			else if constexpr (IS_PASSTHROUGH)
 			{
 				if (!JPL_ENSURE(nodeLayout.BusConfig.Inputs.size() == 1 && nodeLayout.BusConfig.Outputs.size() == 1))
 				{
@@ -286,50 +679,274 @@ namespace JPL
 				}
 			}
 
+			if constexpr (IS_IN_PLACE && !IS_FIXED_LAYOUT)
+			{
+				if (!JPL_ENSURE(Internal::HasMatchingInPlaceBuses(nodeLayout.BusConfig.Inputs, nodeLayout.BusConfig.Outputs),
+								"In place node must have the same number of channels on paired Input and Output busses."))
+					return false;
+			}
+
 			static constexpr ma_node_vtable vtable
 			{
 				.onProcess = sProcess,
-				.inputBusCount = IS_PASSTHROUGH ? 1 : MA_NODE_BUS_COUNT_UNKNOWN,
-				.outputBusCount = IS_PASSTHROUGH ? 1 : MA_NODE_BUS_COUNT_UNKNOWN,
+				.onGetRequiredInputFrameCount = GetVTableRequiredInputFrameCountCallback(),
+				.inputBusCount = GetVTableInputBusCount(),
+				.outputBusCount = GetVTableOutputBusCount(),
 				.flags = TNode::FLAGS
 			};
 			
 			ma_node_config config = BaseNode::InitConfig(nodeLayout, initStarted);
 			config.vtable = &vtable;
 
-			ma_engine* engine = GetMiniaudioEngine(nullptr);
+			MA::Engine& engine = nodeLayout.Engine ? *nodeLayout.Engine : GetMiniaudioEngine(nullptr);
+			if (!engine)
+				return false;
+
 			const ma_result result = this->emplace(&engine->nodeGraph, &config, gEngineAllocationCallbacks);
 
 			if (!JPL_ENSURE(!result))
 			{
-				TNode* node = this->release();
-				delete node;
+				this->discard();
 				return false;
 			}
 
 			return true;
 		}
 
+		bool Init(bool initStarted = true) requires (IS_FIXED_LAYOUT)
+		{
+			return Init(GetFixedNodeLayout(), initStarted);
+		}
+
+		bool Init(Engine& engine, bool initStarted = true) requires (IS_FIXED_LAYOUT)
+		{
+			return Init(GetFixedNodeLayout().WithEngine(engine), initStarted);
+		}
+
 		bool StartNode() { return ma_node_set_state(this->get(), ma_node_state_started) == MA_SUCCESS; }
 		bool StopNode() { return ma_node_set_state(this->get(), ma_node_state_stopped) == MA_SUCCESS; }
 
+		// @returns true if the node skipped processing of the last block, having silent inputs past its tail
+		bool IsSleeping() const requires (SLEEPS_ON_SILENCE)
+		{
+			return this->get() && this->get()->SleepState.bSleeping.load(std::memory_order_relaxed);
+		}
+
 	private:
+		static constexpr ma_uint32 GetVTableInputBusCount()
+		{
+			if constexpr (IS_FIXED_LAYOUT) return TLayout::NUM_INPUT_BUSES;
+			else return IS_PASSTHROUGH ? 1 : MA_NODE_BUS_COUNT_UNKNOWN;
+		}
+
+		static constexpr ma_uint32 GetVTableOutputBusCount()
+		{
+			if constexpr (IS_FIXED_LAYOUT) return TLayout::NUM_OUTPUT_BUSES;
+			else return IS_PASSTHROUGH ? 1 : MA_NODE_BUS_COUNT_UNKNOWN;
+		}
+
+		static constexpr OnGetRequiredInputFrameCountCb GetVTableRequiredInputFrameCountCallback()
+		{
+			if constexpr (HAS_REQUIRED_INPUT_FRAME_COUNT) return sGetRequiredInputFrameCount;
+			else return nullptr;
+		}
+
+		static NodeLayout GetFixedNodeLayout() requires (IS_FIXED_LAYOUT)
+		{
+			NodeLayout nodeLayout;
+			nodeLayout.BusConfig.Inputs = std::span(TLayout::INPUT_CHANNELS);
+			nodeLayout.BusConfig.Outputs = std::span(TLayout::OUTPUT_CHANNELS);
+			return nodeLayout;
+		}
+
+		static bool MatchesLayout(const BusConfig& busConfig) requires (IS_FIXED_LAYOUT)
+		{
+			return std::ranges::equal(busConfig.Inputs, TLayout::INPUT_CHANNELS)
+				&& std::ranges::equal(busConfig.Outputs, TLayout::OUTPUT_CHANNELS);
+		}
+
 		static void sProcess(ma_node* pNode, const float** ppFramesIn, ma_uint32* pFrameCountIn, float** ppFramesOut, ma_uint32* pFrameCountOut)
 		{
-			const uint32_t numInBusses = ma_node_get_input_bus_count(pNode);
-			const uint32_t numOutBusses = ma_node_get_output_bus_count(pNode);
-			
-			JPL::ProcessCallbackData callbackData(
-				numInBusses,
-				numOutBusses,
-				static_cast<ma_node_base*>(pNode),
-				ppFramesIn,
-				pFrameCountIn,
-				ppFramesOut,
-				pFrameCountOut
-			);
-
-			static_cast<TNode*>(pNode)->Process(std::ref(callbackData));
+			ScopedFlushDenormals flushDenormals(FLUSHES_DENORMALS);
+
+			uint32_t numInBusses, numOutBusses;
+			if constexpr (IS_FIXED_LAYOUT)
+			{
+				numInBusses = TLayout::NUM_INPUT_BUSES;
+				numOutBusses = TLayout::NUM_OUTPUT_BUSES;
+			}
+			else
+			{
+				numInBusses = ma_node_get_input_bus_count(pNode);
+				numOutBusses = ma_node_get_output_bus_count(pNode);
+			}
+
+			if constexpr (!HAS_DIFFERENT_PROCESSING_RATES)
+			{
+				// With a custom processing size the graph may hand us fewer input frames
+				// than the output has space for (e.g. when pulled through a splitter's cache).
+				// Fixed rate nodes consume and produce the same number of frames,
+				// so report back exactly what's processed instead of outputting garbage.
+				if (numInBusses > 0 && ppFramesIn != nullptr)
+				{
+					const ma_uint32 numFrames = std::min(*pFrameCountIn, *pFrameCountOut);
+					*pFrameCountIn = numFrames;
+					*pFrameCountOut = numFrames;
+				}
+			}
+
+			auto* node = static_cast<Internal::TNodeStorage<TNode, TLayout>*>(pNode);
+
+			if constexpr (SLEEPS_ON_SILENCE)
+			{
+				if (UpdateSleepState(*node, pNode, ppFramesIn, numInBusses, *pFrameCountOut))
+				{
+					for (uint32_t i = 0; i < numOutBusses; ++i)
+						DSP::Silence(ppFramesOut[i], *pFrameCountOut * GetNumOutputChannels(pNode, i));
+					return;
+				}
+			}
+
+#if defined(JPL_ENABLE_NODE_PROFILING)
+			const auto processStart = std::chrono::steady_clock::now();
+#endif
+
+			if constexpr (IS_PLANAR)
+			{
+				ProcessPlanar(pNode, ppFramesIn, pFrameCountOut, ppFramesOut);
+			}
+			else
+			{
+				auto callbackData = [&]
+				{
+					if constexpr (IS_FIXED_LAYOUT)
+						return CallbackData(static_cast<ma_node_base*>(pNode), ppFramesIn, pFrameCountIn, ppFramesOut, pFrameCountOut);
+					else
+						return CallbackData(numInBusses, numOutBusses, static_cast<ma_node_base*>(pNode), ppFramesIn, pFrameCountIn, ppFramesOut, pFrameCountOut);
+				}();
+
+				if constexpr (IS_IN_PLACE)
+				{
+					if (callbackData.IsNullInput())
+						callbackData.FillOutputWithSilence();
+					else
+						callbackData.CopyInputsToOutputs();
+				}
+
+				node->Process(std::ref(callbackData));
+			}
+
+#if defined(JPL_ENABLE_NODE_PROFILING)
+			const auto processingTime = std::chrono::steady_clock::now() - processStart;
+			node->ProfilerEntry.Stats.Record(static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(processingTime).count()));
+#endif
+		}
+
+		static ma_result sGetRequiredInputFrameCount(ma_node* pNode, ma_uint32 outputFrameCount, ma_uint32* pInputFrameCount)
+		{
+			auto* node = static_cast<Internal::TNodeStorage<TNode, TLayout>*>(pNode);
+			*pInputFrameCount = node->GetRequiredInputFrameCount(outputFrameCount);
+			return MA_SUCCESS;
+		}
+
+		JPL_INLINE static uint32_t GetNumInputChannels(ma_node* pNode, uint32_t busIndex)
+		{
+			if constexpr (IS_FIXED_LAYOUT) return TLayout::INPUT_CHANNELS[busIndex];
+			else return ma_node_get_input_channels(pNode, busIndex);
+		}
+
+		JPL_INLINE static uint32_t GetNumOutputChannels(ma_node* pNode, uint32_t busIndex)
+		{
+			if constexpr (IS_FIXED_LAYOUT) return TLayout::OUTPUT_CHANNELS[busIndex];
+			else return ma_node_get_output_channels(pNode, busIndex);
+		}
+
+		// @returns true if none of the inputs has a non-zero sample, or there's no input at all
+		static bool AreInputsSilent(ma_node* pNode, const float** ppFramesIn, uint32_t numInBusses, uint32_t numFrames)
+		{
+			if (ppFramesIn == nullptr)
+				return true;
+
+			for (uint32_t i = 0; i < numInBusses; ++i)
+			{
+				if (DSP::FindPeak(ppFramesIn[i], numFrames * GetNumInputChannels(pNode, i)) > 0.0f)
+					return false;
+			}
+			return true;
+		}
+
+		// @returns true if the block must be skipped, inputs having been silent for longer than the tail
+		static bool UpdateSleepState(Internal::TNodeStorage<TNode, TLayout>& node, ma_node* pNode, const float** ppFramesIn, uint32_t numInBusses, uint32_t numFrames) requires (SLEEPS_ON_SILENCE)
+		{
+			auto& state = node.SleepState;
+
+			// Generators have nothing to wait for
+			if (numInBusses == 0 || !AreInputsSilent(pNode, ppFramesIn, numInBusses, numFrames))
+			{
+				state.NumSilentFrames = 0;
+				state.bSleeping.store(false, std::memory_order_relaxed);
+				return false;
+			}
+
+			// Keep processing until the whole tail has been rendered
+			const bool bTailFinished = state.NumSilentFrames >= node.GetTailLengthInFrames();
+			if (!bTailFinished)
+				state.NumSilentFrames += numFrames;
+
+			state.bSleeping.store(bTailFinished, std::memory_order_relaxed);
+			return bTailFinished;
+		}
+
+		// Deinterleave inputs, process, and interleave outputs, in blocks that fit the scratch
+		static void ProcessPlanar(ma_node* pNode, const float** ppFramesIn, ma_uint32* pFrameCount, float** ppFramesOut) requires (IS_PLANAR)
+		{
+			static constexpr uint32_t BLOCK_SIZE = TLayout::PLANAR_BLOCK_SIZE;
+
+			auto* node = static_cast<Internal::TNodeStorage<TNode, TLayout>*>(pNode);
+			auto& scratch = node->PlanarScratch;
+			using Scratch = std::remove_reference_t<decltype(scratch)>;
+
+			std::array<float*, Scratch::NUM_INPUTS> inputChannels;
+			std::array<float*, Scratch::NUM_OUTPUTS> outputChannels;
+			for (uint32_t channel = 0; channel < inputChannels.size(); ++channel)
+				inputChannels[channel] = scratch.Inputs[channel];
+			for (uint32_t channel = 0; channel < outputChannels.size(); ++channel)
+				outputChannels[channel] = scratch.Outputs[channel];
+
+			const bool bNullInput = ppFramesIn == nullptr || TLayout::NUM_INPUT_BUSES == 0;
+			const uint32_t numFrames = *pFrameCount;
+
+			for (uint32_t blockStart = 0; blockStart < numFrames; blockStart += BLOCK_SIZE)
+			{
+				ma_uint32 blockSize = std::min(BLOCK_SIZE, numFrames - blockStart);
+
+				if (!bNullInput)
+				{
+					for (uint32_t bus = 0; bus < TLayout::NUM_INPUT_BUSES; ++bus)
+					{
+						DSP::Deinterleave(ppFramesIn[bus] + blockStart * TLayout::INPUT_CHANNELS[bus],
+									 inputChannels.data() + TLayout::INPUT_CHANNEL_OFFSETS[bus],
+									 TLayout::INPUT_CHANNELS[bus],
+									 blockSize);
+					}
+				}
+
+				CallbackData callbackData(static_cast<ma_node_base*>(pNode),
+										  bNullInput ? nullptr : inputChannels.data(),
+										  &blockSize,
+										  outputChannels.data(),
+										  &blockSize);
+
+				node->Process(std::ref(callbackData));
+
+				for (uint32_t bus = 0; bus < TLayout::NUM_OUTPUT_BUSES; ++bus)
+				{
+					DSP::Interleave(outputChannels.data() + TLayout::OUTPUT_CHANNEL_OFFSETS[bus],
+							   ppFramesOut[bus] + blockStart * TLayout::OUTPUT_CHANNELS[bus],
+							   TLayout::OUTPUT_CHANNELS[bus],
+							   blockSize);
+				}
+			}
 		}
 	};
 
@@ -340,6 +957,7 @@ namespace JPL
 		TRAIT_DEFS(Internal::SplitterNode);
 
 		bool Init(uint32_t numChannels, uint32_t numOutputBusses = 2);
+		bool Init(Engine& engine, uint32_t numChannels, uint32_t numOutputBusses = 2);
 	};
 
 	//==========================================================================
@@ -355,18 +973,75 @@ namespace JPL
 			bool PitchDisabled = false;
 		};
 		bool InitGroup(const GroupNodeSettings& settings);
+		bool InitGroup(Engine& engine, const GroupNodeSettings& settings);
 
 		void SetPitch(float pitch);
 		float GetPitch() const;
 	};
 
+	//==========================================================================
+	/// Handle to a sound being loaded on the resource manager's job threads, see Sound::InitAsync.
+	/// Cheap to copy, all of the copies refer to the same load.
+	class SoundLoad
+	{
+	public:
+		// Called on a job thread once the sound has finished loading, or failed to load.
+		// Must be short, and must not uninitialize the sound.
+		using Callback = std::function<void(bool bSucceeded)>;
+
+		SoundLoad() = default;
+
+		bool IsValid() const { return mState != nullptr; }
+
+		// Doesn't block
+		bool IsDone() const;
+
+		// Block until the sound has finished loading.
+		// @returns true if the sound has loaded successfully
+		bool Wait() const;
+
+		// Block until all of the sounds have finished loading, e.g. at the end of a level load.
+		// Invalid handles are skipped.
+		// @returns true if all of the sounds have loaded successfully
+		static bool WaitAll(std::span<const SoundLoad> loads);
+
+	private:
+		friend struct Sound;
+		explicit SoundLoad(std::shared_ptr<Internal::AsyncLoadState> state) : mState(std::move(state)) {}
+
+		std::shared_ptr<Internal::AsyncLoadState> mState;
+	};
+
 	//==========================================================================
 	struct Sound	: Traits::NodeDefaultTraits<Internal::Sound>
 	{
 		TRAIT_DEFS(Internal::Sound);
 
+		Sound() = default;
+		~Sound();
+		Sound(Sound&& other) noexcept;
+		Sound& operator=(Sound&& other) noexcept;
+
+		// Uninitialize the sound, waiting for its load to finish if it's loaded asynchronously
+		void clear();
+
 		bool Init(const char* filePathOrId, uint32_t flags, bool bUseSourceChannelCount = false);
+		bool Init(Engine& engine, const char* filePathOrId, uint32_t flags, bool bUseSourceChannelCount = false);
 		bool InitFromDataSource(Internal::DataSource& dataSource, uint32_t flags);
+		bool InitFromDataSource(Engine& engine, Internal::DataSource& dataSource, uint32_t flags);
+		// Any miniaudio data source, e.g. ma_audio_buffer_ref. Must outlive the sound.
+		bool InitFromDataSource(Engine& engine, ma_data_source* dataSource, uint32_t flags);
+
+		// Initialize a new instance sharing the data of the 'source' sound, without decoding it again.
+		// The source must have been initialized synchronously from a file loaded by the resource manager, and not streamed.
+		bool InitCopy(const Sound& source, uint32_t flags);
+
+		// Initialize the sound and return right away, decoding the file on the resource manager's job threads.
+		// The sound can be started before it's loaded, it plays silence until the data is ready.
+		// Destroying or reinitializing the sound waits for the load to finish, regardless of the SoundLoad handles kept.
+		// @returns invalid handle if the sound failed to initialize
+		SoundLoad InitAsync(const char* filePathOrId, uint32_t flags, SoundLoad::Callback onLoaded = nullptr);
+		SoundLoad InitAsync(Engine& engine, const char* filePathOrId, uint32_t flags, SoundLoad::Callback onLoaded = nullptr);
 
 		void SetVolume(float volume);
 		float GetVolume() const;
@@ -390,15 +1065,72 @@ namespace JPL
 		float GetLengthInSeconds();
 		float GetCursorInSeconds();
 
-		/*	TODO: the rest of the interface(not needed for now)
-			void ma_sound_set_start_time_in_pcm_frames(ma_sound* pSound, ma_uint64 absoluteGlobalTimeInFrames);
-			void ma_sound_set_start_time_in_milliseconds(ma_sound* pSound, ma_uint64 absoluteGlobalTimeInMilliseconds);
-			void ma_sound_set_stop_time_in_pcm_frames(ma_sound* pSound, ma_uint64 absoluteGlobalTimeInFrames);
-			void ma_sound_set_stop_time_in_milliseconds(ma_sound* pSound, ma_uint64 absoluteGlobalTimeInMilliseconds);
-			ma_uint64 ma_sound_get_time_in_pcm_frames(const ma_sound* pSound);
-			ma_uint64 ma_sound_get_time_in_milliseconds(const ma_sound* pSound);
-			ma_result ma_sound_set_end_callback(ma_sound* pSound, ma_sound_end_proc callback, void* pUserData);
-		*/
+		//======================================================================
+		/// Virtual voice.
+		/// Virtual sound is stopped and detached from the graph, so it's not decoded or mixed,
+		/// but its cursor keeps advancing with the engine time as if it was still playing.
+		/// Devirtualizing reattaches the sound and resumes it from where it would be by now.
+		/// Pitch is sampled at the time of virtualization and devirtualization, changes in between are not tracked.
+
+		// Only a playing sound can be virtualized
+		bool Virtualize();
+
+		// Non-looping sound that would have reached its end while virtual stays stopped.
+		// @returns false if the sound is not virtual or failed to resume
+		bool Devirtualize();
+
+		bool IsVirtual() const { return mVirtual.has_value(); }
+
+		// Cursor the sound would be at if it was playing, or the actual cursor if it's not virtual
+		uint64_t GetVirtualCursorInFrames();
+
+		//======================================================================
+		/// Scheduling.
+		/// Times are absolute engine times (see Engine::GetTimeInFrames), applied by the audio thread
+		/// with sample accuracy, so sounds scheduled for the same time start together
+		/// regardless of when the game thread got to schedule them.
+		/// Times that have already passed take effect at the start of the next audio block.
+		/// To schedule several sounds within the same audio block, use CommandBatch::ScheduleStart/ScheduleStop.
+
+		// Start the sound at the engine time, it's silent until then.
+		// Clears the previously scheduled stop time.
+		bool StartAtFrame(uint64_t engineTimeInFrames);
+		bool StartAtMilliseconds(uint64_t engineTimeInMilliseconds);
+
+		// Stop the sound at the engine time, fading out over 'fadeLengthInFrames' frames before it
+		void StopAtFrame(uint64_t engineTimeInFrames, uint64_t fadeLengthInFrames = 0);
+		void StopAtMilliseconds(uint64_t engineTimeInMilliseconds);
+
+		// Clear the scheduled stop time, e.g. to keep playing a sound that was going to stop
+		void ClearStopTime();
+
+		// Number of frames the sound has been processed for
+		uint64_t GetTimeInFrames() const;
+		uint64_t GetTimeInMilliseconds() const;
+
+		// Called on the audio thread when the sound reaches its end.
+		// Must not call into user code that may block, see SoundEndQueue to handle it on the game thread.
+		void SetEndCallback(ma_sound_end_proc callback, void* userData);
+
+	private:
+		struct VirtualState
+		{
+			uint64_t StartTime;			// Engine time in frames
+			uint64_t StartCursor;		// Cursor of the sound in its own frames
+			double FramesPerEngineFrame;	// Pitch and sample rate conversion
+			ma_node* OutputNode;		// Attachment of the output bus to restore
+			uint32_t OutputNodeInputBus;
+		};
+		std::optional<VirtualState> mVirtual;
+
+		// Block until the job threads are done with the asynchronous load, if any
+		void WaitForLoad();
+
+		// Uninitialize the sound before releasing the data source of its load
+		void Reset();
+
+		// Owns the data source of an asynchronously loaded sound, kept until the sound is reinitialized
+		std::shared_ptr<Internal::AsyncLoadState> mLoadState;
 	};
 
 	//==========================================================================
@@ -407,6 +1139,7 @@ namespace JPL
 		TRAIT_DEFS(Internal::LPFNode);
 
 		bool Init(uint32_t numChannels, double cutoffFrequency, uint32_t order, uint32_t sampleRate = 0);
+		bool Init(Engine& engine, uint32_t numChannels, double cutoffFrequency, uint32_t order, uint32_t sampleRate = 0);
 
 		void SetCutoffFrequency(double newCutoffFrequency);
 		double GetCutoffFrequency() const { return mCutoffFrequency; }
@@ -414,6 +1147,7 @@ namespace JPL
 		uint32 GetOrder() const { return mOrder; }
 
 	private:
+		friend class CommandBatch;
 		uint32_t mOrder = 0;
 		double mCutoffFrequency = 0.0;
 	};
@@ -424,12 +1158,14 @@ namespace JPL
 		TRAIT_DEFS(Internal::LPFNode);
 
 		bool Init(uint32_t numChannels, double cutoffFrequency, uint32_t order, uint32_t sampleRate = 0);
+		bool Init(Engine& engine, uint32_t numChannels, double cutoffFrequency, uint32_t order, uint32_t sampleRate = 0);
 
 		void SetCutoffFrequency(double newCutoffFrequency);
 		double GetCutoffFrequency() const { return mCutoffFrequency; }
 		uint32 GetOrder() const { return mOrder; }
 
 	private:
+		friend class CommandBatch;
 		uint32_t mOrder = 0;
 		double mCutoffFrequency = 0.0;
 	};
@@ -0,0 +1,143 @@
+﻿//
+//      ██╗██████╗     ██╗     ██╗██████╗ ███████╗
+//      ██║██╔══██╗    ██║     ██║██╔══██╗██╔════╝		** MiniaudioCpp **
+//      ██║██████╔╝    ██║     ██║██████╔╝███████╗
+// ██   ██║██╔═══╝     ██║     ██║██╔══██╗╚════██║		https://github.com/Jaytheway/MiniaudioCpp
+// ╚█████╔╝██║         ███████╗██║██████╔╝███████║
+//  ╚════╝ ╚═╝         ╚══════╝╚═╝╚═════╝ ╚══════╝
+//
+//   Copyright 2024 Jaroslav Pevno, MiniaudioCpp is offered under the terms of the ISC license:
+//
+//   Permission to use, copy, modify, and/or distribute this software for any purpose with or
+//   without fee is hereby granted, provided that the above copyright notice and this permission
+//   notice appear in all copies. THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+//   WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+//   AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+//   CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+//   WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+//   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#pragma once
+
+#include "Core.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace JPL
+{
+	//==========================================================================
+	/// Processing time of a single node, written by the audio thread only
+	/// and can be read from any thread without locks.
+	struct NodeProcessingStats
+	{
+		std::atomic<uint64> NumCalls{ 0 };
+		std::atomic<uint64> TotalNs{ 0 };
+		std::atomic<uint64> PeakNs{ 0 };
+		std::atomic<uint64> LastNs{ 0 };
+
+		// Audio thread
+		JPL_INLINE void Record(uint64 ns)
+		{
+			// Single writer, so there is no need for RMW operations
+			NumCalls.store(NumCalls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			TotalNs.store(TotalNs.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+			LastNs.store(ns, std::memory_order_relaxed);
+			if (ns > PeakNs.load(std::memory_order_relaxed))
+				PeakNs.store(ns, std::memory_order_relaxed);
+		}
+	};
+
+	//==========================================================================
+	/// Registry of processing time of custom nodes (TBaseNode).
+	///
+	/// Processing time is only recorded if compiled with JPL_ENABLE_NODE_PROFILING
+	/// (MINIAUDIOCPP_NODE_PROFILING CMake option), otherwise there is nothing to report.
+	///
+	/// The audio thread only writes to the stats of the node it processes,
+	/// the registry lock is only taken when nodes are created, destroyed or reported.
+	class NodeProfiler
+	{
+	public:
+		struct NodeReport
+		{
+			std::string_view Name;
+			const void* Node = nullptr;
+			uint64 NumCalls = 0;
+			uint64 TotalNs = 0;
+			uint64 PeakNs = 0;
+			uint64 LastNs = 0;
+
+			double GetAverageNs() const { return NumCalls > 0 ? static_cast<double>(TotalNs) / NumCalls : 0.0; }
+		};
+
+		//======================================================================
+		/// Registration of a node, embedded into the node's memory.
+		/// Registers on construction and unregisters on destruction.
+		class Entry
+		{
+		public:
+			Entry(std::string_view name, const void* node);
+			~Entry();
+
+			Entry(const Entry&) = delete;
+			Entry& operator=(const Entry&) = delete;
+
+			NodeProcessingStats Stats;
+
+		private:
+			friend class NodeProfiler;
+			std::string_view mName;
+			const void* mNode;
+		};
+
+		NodeProfiler() = delete;
+
+		// Most expensive nodes by total processing time, up to 'maxNodes'
+		static std::vector<NodeReport> GetTopNodes(uint32 maxNodes);
+
+		// Human readable table of the most expensive nodes
+		static std::string FormatTopNodes(uint32 maxNodes);
+
+		static uint32 GetNumRegisteredNodes();
+
+		// Reset stats of all registered nodes.
+		// Stats written by the audio thread at the same time may survive the reset.
+		static void ResetAll();
+	};
+
+	namespace Internal
+	{
+		/// Name of the type 'T' without relying on RTTI, e.g. "MyNamespace::MyNode"
+		template<class T>
+		constexpr std::string_view GetTypeName()
+		{
+#if defined(JPL_COMPILER_MSVC)
+			constexpr std::string_view function = __FUNCSIG__;
+			constexpr std::string_view prefix = "GetTypeName<";
+			constexpr std::string_view suffix = ">(void)";
+#else
+			constexpr std::string_view function = __PRETTY_FUNCTION__;
+			constexpr std::string_view prefix = "T = ";
+			constexpr std::string_view suffix = "]";
+#endif
+			std::string_view name = function.substr(function.find(prefix) + prefix.size());
+			name = name.substr(0, name.rfind(suffix));
+
+#if defined(JPL_COMPILER_MSVC)
+			for (std::string_view keyword : { "struct ", "class " })
+			{
+				if (name.starts_with(keyword))
+					name.remove_prefix(keyword.size());
+			}
+#elif defined(JPL_COMPILER_GCC)
+			// GCC appends aliases used in the signature, e.g. "; std::string_view = ..."
+			name = name.substr(0, name.find(';'));
+#endif
+			return name;
+		}
+	} // namespace Internal
+} // namespace JPL
@@ -44,6 +44,7 @@ namespace JPL
 	using InputBus = Bus<true>;
 	using OutputBus = Bus<false>;
 	struct NodeIO;
+	class CommandBatch;
 
 	//======================================================================
 	/// Handy aliases to avoid typing templates
@@ -75,6 +76,7 @@ namespace JPL
 	private:
 		friend struct Bus<true>;
 		friend struct Bus<false>;
+		friend class CommandBatch;
 		ma_node_base* GetMaOwner();
 		ma_node_base* GetMaOwner() const;
 
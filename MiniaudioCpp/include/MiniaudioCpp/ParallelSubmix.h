@@ -0,0 +1,107 @@
+﻿//
+//      ██╗██████╗     ██╗     ██╗██████╗ ███████╗
+//      ██║██╔══██╗    ██║     ██║██╔══██╗██╔════╝		** MiniaudioCpp **
+//      ██║██████╔╝    ██║     ██║██████╔╝███████╗
+// ██   ██║██╔═══╝     ██║     ██║██╔══██╗╚════██║		https://github.com/Jaytheway/MiniaudioCpp
+// ╚█████╔╝██║         ███████╗██║██████╔╝███████║
+//  ╚════╝ ╚═╝         ╚══════╝╚═╝╚═════╝ ╚══════╝
+//
+//   Copyright 2024 Jaroslav Pevno, MiniaudioCpp is offered under the terms of the ISC license:
+//
+//   Permission to use, copy, modify, and/or distribute this software for any purpose with or
+//   without fee is hereby granted, provided that the above copyright notice and this permission
+//   notice appear in all copies. THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+//   WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+//   AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+//   CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+//   WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+//   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#pragma once
+
+#include "Core.h"
+#include "MiniaudioWrappers.h"
+
+#include <memory>
+#include <vector>
+
+namespace JPL
+{
+	class WorkStealingPool;
+
+	//==========================================================================
+	/// Node that processes independent submixes in parallel on a pool of worker threads.
+	///
+	/// miniaudio pulls the node graph recursively on a single thread, so branches
+	/// of the same graph can't be processed concurrently. Instead, each submix
+	/// (e.g. a group of voices with its effects) is built in its own offline Engine,
+	/// owned by this node, which makes the branches independent by construction.
+	/// The submix engines share the parent engine's resource manager, so sounds
+	/// are loaded and cached once regardless of which submix plays them.
+	///
+	/// When the parent engine pulls this node, all of the submix engines are rendered
+	/// in parallel, the calling audio thread participates, and the results are
+	/// joined into this node's single output bus.
+	///
+	/// Usage:
+	///		ParallelSubmixNode submixes;
+	///		submixes.Init(engine, { .NumSubmixes = 20 });
+	///		sound.Init(submixes.GetSubmix(i), ...);	// build each submix in its own engine
+	///		submixes.GetOutputBus().AttachTo(engine.GetEndpointBus());
+	class ParallelSubmixNode
+	{
+	public:
+		struct SubmixSettings
+		{
+			uint32_t NumSubmixes = 0;
+			uint32_t NumChannels = 0;		// 0 - use channel count of the parent engine
+			uint32_t NumWorkerThreads = 0;	// 0 - use one less than hardware concurrency, the audio thread is the last worker
+		};
+
+		ParallelSubmixNode();
+		~ParallelSubmixNode();
+
+		// Submix node holds a pointer to itself within the node, so it can't be moved or copied
+		ParallelSubmixNode(const ParallelSubmixNode&) = delete;
+		ParallelSubmixNode& operator=(const ParallelSubmixNode&) = delete;
+
+		bool Init(Engine& engine, const SubmixSettings& settings);
+		bool IsInitialized() const { return mNode.get() != nullptr; }
+
+		uint32_t GetNumSubmixes() const { return static_cast<uint32_t>(mSubmixes.size()); }
+		uint32_t GetNumWorkerThreads() const;
+
+		// Offline engine to build a submix in
+		Engine& GetSubmix(uint32_t submixIndex) { return mSubmixes[submixIndex]; }
+
+		// Joined output of all of the submixes
+		OutputBus GetOutputBus() { return mNode.OutputBus(0); }
+
+	private:
+		struct MixNode
+		{
+			ma_node_base base;
+			static constexpr int FLAGS = 0;
+
+			ParallelSubmixNode* Owner = nullptr;
+
+			void Process(ProcessCallbackData& data);
+		};
+
+		// Called from the audio thread
+		void RenderSubmixes(float* output, uint32_t numFrames);
+		static void RenderSubmixTask(void* context, uint32 submixIndex);
+
+	private:
+		std::unique_ptr<WorkStealingPool> mPool;
+		std::vector<Engine> mSubmixes;
+		std::vector<float> mSubmixBuffers;	// Interleaved buffer of a block size for each submix
+
+		uint32_t mNumChannels = 0;
+		uint32_t mMaxBlockSize = 0;
+		uint32_t mCurrentBlockSize = 0;
+
+		// Must be destroyed first, to stop processing before the submixes are gone
+		TBaseNode<MixNode> mNode;
+	};
+} // namespace JPL
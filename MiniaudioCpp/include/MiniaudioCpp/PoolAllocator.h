@@ -0,0 +1,217 @@
+﻿//
+//      ██╗██████╗     ██╗     ██╗██████╗ ███████╗
+//      ██║██╔══██╗    ██║     ██║██╔══██╗██╔════╝		** MiniaudioCpp **
+//      ██║██████╔╝    ██║     ██║██████╔╝███████╗
+// ██   ██║██╔═══╝     ██║     ██║██╔══██╗╚════██║		https://github.com/Jaytheway/MiniaudioCpp
+// ╚█████╔╝██║         ███████╗██║██████╔╝███████║
+//  ╚════╝ ╚═╝         ╚══════╝╚═╝╚═════╝ ╚══════╝
+//
+//   Copyright 2024 Jaroslav Pevno, MiniaudioCpp is offered under the terms of the ISC license:
+//
+//   Permission to use, copy, modify, and/or distribute this software for any purpose with or
+//   without fee is hereby granted, provided that the above copyright notice and this permission
+//   notice appear in all copies. THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+//   WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+//   AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+//   CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+//   WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+//   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#pragma once
+
+#include "Core.h"
+
+#include "miniaudio/miniaudio.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace JPL
+{
+	//==========================================================================
+	/// What the memory was allocated for, allocations are accounted per category.
+	/// Each category has its own set of ma_allocation_callbacks, see PoolAllocator::GetCallbacks.
+	enum class EAllocationCategory : uint8
+	{
+		Engine,		// Engine, device, resource manager, and sounds (which use the engine's callbacks)
+		Nodes,		// Nodes and other objects initialized with gEngineAllocationCallbacks
+		Other,
+
+		Count
+	};
+
+	//==========================================================================
+	/// Allocator for miniaudio objects, meant to be plugged in via ma_allocation_callbacks.
+	///
+	/// Small allocations are served from per size class free lists, carved out of large
+	/// regions of memory, so churn of nodes and sounds doesn't go through the general-purpose heap.
+	/// Each thread keeps a small cache of free blocks per size class, so most allocations
+	/// and frees don't take any locks. Allocations larger than the largest size class
+	/// (e.g. decoded audio data) go to the heap, but are still accounted.
+	///
+	/// In arena mode (ArenaSizeInBytes > 0) all of the pooled memory is allocated up front
+	/// and never grows, small allocations fail once the arena is exhausted.
+	///
+	/// The allocator must outlive all of the objects allocated with it, and all of the threads
+	/// that used it must either exit or switch to another allocator before it is destroyed.
+	/// Thread caches are designed for a single allocator being used at a time,
+	/// switching between allocators on the same thread flushes the cache.
+	///
+	/// Usage:
+	///		static PoolAllocator sAllocator;
+	///		gEngineAllocationCallbacks = sAllocator.GetCallbacks(EAllocationCategory::Nodes);
+	///		engine.Init({ .AllocationCallbacks = sAllocator.GetCallbacks(EAllocationCategory::Engine) });
+	class PoolAllocator
+	{
+	public:
+		struct AllocatorSettings
+		{
+			// Size of the single preallocated region for all of the pooled memory.
+			// 0 - grow by 'RegionSizeInBytes' regions on demand.
+			uint64 ArenaSizeInBytes = 0;
+
+			// Size of the regions to grow by when not in arena mode
+			uint64 RegionSizeInBytes = 256 * 1024;
+
+			// Max number of free blocks cached per size class per thread.
+			// 0 - disable thread caches, every allocation takes a lock of the size class.
+			uint32 ThreadCacheSize = 32;
+		};
+
+		struct CategoryStats
+		{
+			uint64 CurrentBytes = 0;	// Requested bytes currently allocated
+			uint64 PeakBytes = 0;
+			uint64 NumAllocations = 0;	// Total number of allocations, including reallocations
+			uint64 NumFrees = 0;
+			uint64 NumFailed = 0;
+		};
+
+		// Block sizes including the header, powers of two from 32 bytes to 16KB
+		static constexpr uint32 cMinBlockSize = 32;
+		static constexpr uint32 cNumSizeClasses = 10;
+		static constexpr uint32 cMaxBlockSize = cMinBlockSize << (cNumSizeClasses - 1);
+
+		PoolAllocator();
+		explicit PoolAllocator(const AllocatorSettings& settings);
+		~PoolAllocator();
+
+		// Callbacks point to the allocator, so it can't be moved or copied
+		PoolAllocator(const PoolAllocator&) = delete;
+		PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+		//======================================================================
+		/// Any thread
+
+		// Callbacks are owned by the allocator and valid for its lifetime
+		ma_allocation_callbacks* GetCallbacks(EAllocationCategory category) { return &mCallbacks[static_cast<size_t>(category)]; }
+
+		void* Allocate(size_t size, EAllocationCategory category);
+		void* Reallocate(void* memory, size_t size, EAllocationCategory category);
+		void Free(void* memory);
+
+		CategoryStats GetStats(EAllocationCategory category) const;
+
+		// Bytes requested by all of the categories combined
+		uint64 GetTotalAllocatedBytes() const;
+
+		// Bytes of pooled memory reserved from the system, including free blocks
+		uint64 GetReservedBytes() const { return mReservedBytes.load(std::memory_order_relaxed); }
+
+		// Bytes of the allocations that were too large to be pooled
+		uint64 GetLargeAllocatedBytes() const { return mLargeBytes.load(std::memory_order_relaxed); }
+
+		bool IsArena() const { return mSettings.ArenaSizeInBytes > 0; }
+
+	private:
+		struct FreeBlock
+		{
+			FreeBlock* Next;
+		};
+
+		// Precedes each allocation, keeps the user memory aligned to max_align_t
+		struct alignas(alignof(std::max_align_t)) BlockHeader
+		{
+			uint64 Size;			// Requested size
+			uint16 SizeClass;		// cLargeSizeClass for allocations that are not pooled
+			uint8 Category;
+		};
+
+		static constexpr uint16 cLargeSizeClass = 0xffff;
+
+		struct SizeClassList
+		{
+			std::mutex Mutex;
+			FreeBlock* Head = nullptr;
+		};
+
+		struct alignas(JPL_CACHE_LINE_SIZE) CategoryCounters
+		{
+			std::atomic<uint64> CurrentBytes{ 0 };
+			std::atomic<uint64> PeakBytes{ 0 };
+			std::atomic<uint64> NumAllocations{ 0 };
+			std::atomic<uint64> NumFrees{ 0 };
+			std::atomic<uint64> NumFailed{ 0 };
+		};
+
+		struct CallbackContext
+		{
+			PoolAllocator* Allocator;
+			EAllocationCategory Category;
+		};
+
+		struct ThreadCache;
+		struct ThreadCacheFlusher;
+
+		static constexpr uint32 GetBlockSize(uint32 sizeClass) { return cMinBlockSize << sizeClass; }
+
+		// Cache of the calling thread bound to this allocator,
+		// nullptr if thread caches are disabled or the thread is exiting
+		ThreadCache* GetThreadCache();
+
+		// Pop a block of the size class from the thread cache, refilling it if empty
+		FreeBlock* PopBlock(uint32 sizeClass);
+		void PushBlock(uint32 sizeClass, FreeBlock* block);
+
+		// Take up to 'maxBlocks' from the shared list, or carve new ones from the regions.
+		// @returns number of blocks linked to 'outHead'
+		uint32 AcquireBlocks(uint32 sizeClass, uint32 maxBlocks, FreeBlock*& outHead);
+		void ReleaseBlocks(uint32 sizeClass, FreeBlock* head, FreeBlock* tail);
+
+		// Carve up to 'maxBlocks' new blocks, must be called with mRegionMutex locked
+		uint32 CarveBlocks(uint32 sizeClass, uint32 maxBlocks, FreeBlock*& outHead);
+
+		void OnAllocated(EAllocationCategory category, uint64 size);
+		void OnFreed(EAllocationCategory category, uint64 size);
+
+		static void* MallocCallback(size_t size, void* userData);
+		static void* ReallocCallback(void* memory, size_t size, void* userData);
+		static void FreeCallback(void* memory, void* userData);
+
+	private:
+		AllocatorSettings mSettings;
+		uint64 mId;	// Unique id to validate thread caches
+
+		std::array<SizeClassList, cNumSizeClasses> mFreeLists;
+
+		std::mutex mRegionMutex;
+		std::vector<void*> mRegions;
+		char* mRegionCursor = nullptr;
+		char* mRegionEnd = nullptr;
+
+		std::array<CategoryCounters, static_cast<size_t>(EAllocationCategory::Count)> mCounters;
+		std::atomic<uint64> mReservedBytes{ 0 };
+		std::atomic<uint64> mLargeBytes{ 0 };
+
+		std::array<CallbackContext, static_cast<size_t>(EAllocationCategory::Count)> mCallbackContexts;
+		std::array<ma_allocation_callbacks, static_cast<size_t>(EAllocationCategory::Count)> mCallbacks;
+
+		// Trivially destructible, so that it's still usable by objects freed during static destruction
+		static thread_local ThreadCache sThreadCache;
+		// Returns cached blocks to the allocator when the thread exits
+		static thread_local ThreadCacheFlusher sThreadCacheFlusher;
+	};
+} // namespace JPL
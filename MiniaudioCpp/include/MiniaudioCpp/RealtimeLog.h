@@ -0,0 +1,113 @@
+﻿//
+//      ██╗██████╗     ██╗     ██╗██████╗ ███████╗
+//      ██║██╔══██╗    ██║     ██║██╔══██╗██╔════╝		** MiniaudioCpp **
+//      ██║██████╔╝    ██║     ██║██████╔╝███████╗
+// ██   ██║██╔═══╝     ██║     ██║██╔══██╗╚════██║		https://github.com/Jaytheway/MiniaudioCpp
+// ╚█████╔╝██║         ███████╗██║██████╔╝███████║
+//  ╚════╝ ╚═╝         ╚══════╝╚═╝╚═════╝ ╚══════╝
+//
+//   Copyright 2024 Jaroslav Pevno, MiniaudioCpp is offered under the terms of the ISC license:
+//
+//   Permission to use, copy, modify, and/or distribute this software for any purpose with or
+//   without fee is hereby granted, provided that the above copyright notice and this permission
+//   notice appear in all copies. THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+//   WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+//   AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+//   CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+//   WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+//   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#pragma once
+
+#include "Core.h"
+
+#include <atomic>
+#include <memory>
+#include <string_view>
+
+namespace JPL
+{
+	//==========================================================================
+	/// Real-time safe log buffer.
+	///
+	/// Messages are copied into preallocated fixed-size records of a bounded
+	/// lock-free multi-producer single-consumer ring, so pushing a message never
+	/// allocates, locks or makes system calls and is safe to do from the audio thread.
+	/// Formatting and output of the messages is left to the consumer, e.g. a background thread.
+	///
+	/// Messages longer than cMaxMessageLength are truncated. If the ring is full,
+	/// the message is dropped and counted, see GetNumDropped.
+	class RealtimeLog
+	{
+	public:
+		static constexpr uint32 cMaxMessageLength = 247;
+		static constexpr uint32 cDefaultCapacity = 256;
+
+		struct Record
+		{
+			uint32 Level;
+			uint32 Length;
+			char Message[cMaxMessageLength + 1];
+
+			std::string_view GetMessage() const { return { Message, Length }; }
+		};
+
+		// 'capacity' is rounded up to the next power of two
+		explicit RealtimeLog(uint32 capacity = cDefaultCapacity);
+
+		RealtimeLog(const RealtimeLog&) = delete;
+		RealtimeLog& operator=(const RealtimeLog&) = delete;
+
+		// Any thread.
+		// New lines and curly braces are stripped from the message,
+		// so that it can be passed to a formatting function as is.
+		// @returns false if the ring is full and the message was dropped
+		bool Push(uint32 level, const char* message);
+
+		// Consumer thread.
+		// Call 'function(const Record&)' for each of the pushed messages, in order.
+		// @returns number of messages consumed
+		template<class Function>
+		uint32 Drain(Function&& function);
+
+		uint32 GetCapacity() const { return static_cast<uint32>(mMask + 1); }
+		uint64 GetNumDropped() const { return mNumDropped.load(std::memory_order_relaxed); }
+
+	private:
+		struct Slot
+		{
+			std::atomic<uint64> Sequence;
+			Record Data;
+		};
+
+		std::unique_ptr<Slot[]> mSlots;
+		uint64 mMask;
+
+		alignas(JPL_CACHE_LINE_SIZE) std::atomic<uint64> mWriteIndex{ 0 };
+		alignas(JPL_CACHE_LINE_SIZE) uint64 mReadIndex = 0;
+		std::atomic<uint64> mNumDropped{ 0 };
+	};
+
+	//==========================================================================
+	template<class Function>
+	inline uint32 RealtimeLog::Drain(Function&& function)
+	{
+		uint32 numConsumed = 0;
+		while (true)
+		{
+			Slot& slot = mSlots[mReadIndex & mMask];
+
+			// Slot is ready for reading once the producer has published 'index + 1'
+			if (slot.Sequence.load(std::memory_order_acquire) != mReadIndex + 1)
+				break;
+
+			function(static_cast<const Record&>(slot.Data));
+
+			// Hand the slot back to producers for the next lap
+			slot.Sequence.store(mReadIndex + GetCapacity(), std::memory_order_release);
+			++mReadIndex;
+			++numConsumed;
+		}
+		return numConsumed;
+	}
+} // namespace JPL
@@ -0,0 +1,121 @@
+﻿//
+//      ██╗██████╗     ██╗     ██╗██████╗ ███████╗
+//      ██║██╔══██╗    ██║     ██║██╔══██╗██╔════╝		** MiniaudioCpp **
+//      ██║██████╔╝    ██║     ██║██████╔╝███████╗
+// ██   ██║██╔═══╝     ██║     ██║██╔══██╗╚════██║		https://github.com/Jaytheway/MiniaudioCpp
+// ╚█████╔╝██║         ███████╗██║██████╔╝███████║
+//  ╚════╝ ╚═╝         ╚══════╝╚═╝╚═════╝ ╚══════╝
+//
+//   Copyright 2024 Jaroslav Pevno, MiniaudioCpp is offered under the terms of the ISC license:
+//
+//   Permission to use, copy, modify, and/or distribute this software for any purpose with or
+//   without fee is hereby granted, provided that the above copyright notice and this permission
+//   notice appear in all copies. THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+//   WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+//   AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+//   CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+//   WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+//   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#pragma once
+
+#include "Core.h"
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace JPL::Internal
+{
+	//==========================================================================
+	/// Pool of objects of type T, allocated in contiguous slabs.
+	///
+	/// Objects that are alive at the same time are packed together, which keeps
+	/// nodes close in memory when the graph is traversed, and freed objects are
+	/// reused in O(1), without going to the heap. Slabs are never returned to the system.
+	///
+	/// Allocation and deallocation take a lock, both are meant to be done on a game
+	/// thread rather than on the audio thread.
+	template<typename T, uint32 SlabSize = 64>
+	class SlabPool
+	{
+	public:
+		static_assert(SlabSize > 0);
+
+		// One pool per type, leaked so that resources can be freed during static destruction
+		static SlabPool& Get()
+		{
+			static SlabPool* sPool = new SlabPool();
+			return *sPool;
+		}
+
+		SlabPool() = default;
+		SlabPool(const SlabPool&) = delete;
+		SlabPool& operator=(const SlabPool&) = delete;
+
+		// @returns value-initialized object
+		T* Allocate()
+		{
+			Slot* slot = nullptr;
+			{
+				std::scoped_lock lock(mMutex);
+				if (!mFreeList)
+					AddSlab();
+
+				slot = mFreeList;
+				mFreeList = slot->Next;
+				++mNumAllocated;
+			}
+			return ::new (static_cast<void*>(slot->Storage)) T();
+		}
+
+		void Deallocate(T* object)
+		{
+			object->~T();
+
+			Slot* slot = reinterpret_cast<Slot*>(object);
+			std::scoped_lock lock(mMutex);
+			slot->Next = mFreeList;
+			mFreeList = slot;
+			--mNumAllocated;
+		}
+
+		uint32 GetNumAllocated() const { std::scoped_lock lock(mMutex); return mNumAllocated; }
+		uint32 GetCapacity() const { std::scoped_lock lock(mMutex); return static_cast<uint32>(mSlabs.size()) * SlabSize; }
+
+	private:
+		union Slot
+		{
+			Slot* Next;
+			alignas(T) std::byte Storage[sizeof(T)];
+		};
+
+		// Must be called with the mutex locked
+		void AddSlab()
+		{
+			Slot* slab = mSlabs.emplace_back(std::make_unique<Slot[]>(SlabSize)).get();
+
+			// Link in address order, so that consecutive allocations are adjacent
+			for (uint32 i = 0; i < SlabSize; ++i)
+				slab[i].Next = i + 1 < SlabSize ? &slab[i + 1] : mFreeList;
+
+			mFreeList = slab;
+		}
+
+	private:
+		mutable std::mutex mMutex;
+		Slot* mFreeList = nullptr;
+		std::vector<std::unique_ptr<Slot[]>> mSlabs;
+		uint32 mNumAllocated = 0;
+	};
+
+	//==========================================================================
+	/// CResource allocation policy, resources of the same type share a SlabPool
+	struct SlabAllocation
+	{
+		template<typename T> static T* Allocate() { return SlabPool<T>::Get().Allocate(); }
+		template<typename T> static void Deallocate(T* resource) { SlabPool<T>::Get().Deallocate(resource); }
+	};
+} // namespace JPL::Internal
@@ -0,0 +1,159 @@
+﻿//
+//      ██╗██████╗     ██╗     ██╗██████╗ ███████╗
+//      ██║██╔══██╗    ██║     ██║██╔══██╗██╔════╝		** MiniaudioCpp **
+//      ██║██████╔╝    ██║     ██║██████╔╝███████╗
+// ██   ██║██╔═══╝     ██║     ██║██╔══██╗╚════██║		https://github.com/Jaytheway/MiniaudioCpp
+// ╚█████╔╝██║         ███████╗██║██████╔╝███████║
+//  ╚════╝ ╚═╝         ╚══════╝╚═╝╚═════╝ ╚══════╝
+//
+//   Copyright 2024 Jaroslav Pevno, MiniaudioCpp is offered under the terms of the ISC license:
+//
+//   Permission to use, copy, modify, and/or distribute this software for any purpose with or
+//   without fee is hereby granted, provided that the above copyright notice and this permission
+//   notice appear in all copies. THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+//   WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+//   AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+//   CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+//   WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+//   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#pragma once
+
+#include "Core.h"
+#include "MiniaudioWrappers.h"
+
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace JPL
+{
+	//==========================================================================
+	/// Delivers sound end notifications from the audio thread to the game thread.
+	///
+	/// Watched sounds push an event into a bounded lock-free queue when they reach their end,
+	/// and the game thread drains all of the events in one go, so there is no need
+	/// to poll IsAtEnd on every sound every frame, and no user code runs on the audio thread.
+	///
+	/// Sounds can also be handed over to the queue with WatchAndRelease, in which case
+	/// they are destroyed after their end has been delivered, e.g. for fire-and-forget one-shots.
+	///
+	/// Pushing never blocks or allocates, and is safe from multiple audio threads (e.g. ParallelSubmix workers).
+	/// If the queue is full the event is dropped and counted, see GetNumDropped.
+	/// Everything else is game thread only.
+	///
+	/// Usage:
+	///		SoundEndQueue endQueue(256);
+	///		endQueue.Watch(music);
+	///		endQueue.WatchAndRelease(std::move(oneShot))->Start();
+	///		...
+	///		endQueue.Drain([](Sound& sound) { OnSoundEnded(sound); });	// once per frame
+	class SoundEndQueue
+	{
+	public:
+		// 'capacity' is rounded up to the next power of two
+		explicit SoundEndQueue(uint32 capacity = 1024);
+		~SoundEndQueue();
+
+		// The queue is referenced by the sounds' end callbacks, so it can't be moved or copied
+		SoundEndQueue(const SoundEndQueue&) = delete;
+		SoundEndQueue& operator=(const SoundEndQueue&) = delete;
+
+		// Notify every time the sound reaches its end, until unwatched.
+		// Replaces the end callback of the sound. The sound must stay at the same address while watched.
+		bool Watch(Sound& sound);
+
+		// Take ownership of the sound and destroy it once its end has been delivered.
+		// @returns the sound to start, or nullptr if it's not initialized
+		Sound* WatchAndRelease(std::unique_ptr<Sound> sound);
+
+		// Stop notifying, pending events of the sound are discarded.
+		// A released sound is destroyed right away.
+		void Unwatch(Sound& sound);
+
+		bool IsWatched(const Sound& sound) const { return mWatchedSounds.contains(&sound); }
+		uint32 GetNumWatched() const { return static_cast<uint32>(mWatchedSounds.size()); }
+
+		// Call 'function(Sound&)' for each of the sounds that ended since the last drain, in order.
+		// Released sounds are destroyed after the function returns.
+		// @returns number of events delivered
+		template<class Function>
+		uint32 Drain(Function&& function);
+		uint32 Drain() { return Drain([](Sound&) {}); }
+
+		// Events lost because the queue was full
+		uint64 GetNumDropped() const { return mNumDropped.load(std::memory_order_relaxed); }
+
+	private:
+		struct Watcher
+		{
+			SoundEndQueue* Queue;
+			Sound* Instance = nullptr;
+			std::unique_ptr<Sound> Owned;		// Set for released sounds
+			std::atomic<uint32> Generation{ 0 };	// Bumped on unwatch, to discard stale events
+		};
+
+		struct EndEvent
+		{
+			Watcher* Source;
+			uint32 Generation;
+			ma_sound* Sound;
+		};
+
+		struct Cell
+		{
+			std::atomic<uint64> Sequence;
+			EndEvent Event;
+		};
+
+		// Audio thread
+		static void OnSoundEnd(void* userData, ma_sound* sound);
+		bool Push(const EndEvent& event);
+
+		// Game thread
+		bool Pop(EndEvent& outEvent);
+		Watcher* AddWatcher(Sound& sound);
+		void RemoveWatcher(Watcher& watcher);
+
+		// @returns watcher to deliver the event to, or nullptr if the event is stale
+		Watcher* Resolve(const EndEvent& event) const;
+
+	private:
+		std::unique_ptr<Cell[]> mCells;
+		uint64 mMask;
+
+		alignas(JPL_CACHE_LINE_SIZE) std::atomic<uint64> mEnqueuePosition{ 0 };
+		alignas(JPL_CACHE_LINE_SIZE) uint64 mDequeuePosition = 0;
+		std::atomic<uint64> mNumDropped{ 0 };
+
+		// Watchers are referenced by the end callbacks, so they're never freed, only reused
+		std::vector<std::unique_ptr<Watcher>> mWatchers;
+		std::vector<Watcher*> mFreeWatchers;
+		std::unordered_map<const Sound*, Watcher*> mWatchedSounds;
+	};
+
+	//==========================================================================
+	template<class Function>
+	inline uint32 SoundEndQueue::Drain(Function&& function)
+	{
+		uint32 numDelivered = 0;
+
+		EndEvent event;
+		while (Pop(event))
+		{
+			Watcher* watcher = Resolve(event);
+			if (!watcher)
+				continue;
+
+			++numDelivered;
+			function(*watcher->Instance);
+
+			// The function may have unwatched the sound
+			if (watcher->Owned && Resolve(event) == watcher)
+				RemoveWatcher(*watcher);
+		}
+
+		return numDelivered;
+	}
+} // namespace JPL
@@ -0,0 +1,100 @@
+﻿//
+//      ██╗██████╗     ██╗     ██╗██████╗ ███████╗
+//      ██║██╔══██╗    ██║     ██║██╔══██╗██╔════╝		** MiniaudioCpp **
+//      ██║██████╔╝    ██║     ██║██████╔╝███████╗
+// ██   ██║██╔═══╝     ██║     ██║██╔══██╗╚════██║		https://github.com/Jaytheway/MiniaudioCpp
+// ╚█████╔╝██║         ███████╗██║██████╔╝███████║
+//  ╚════╝ ╚═╝         ╚══════╝╚═╝╚═════╝ ╚══════╝
+//
+//   Copyright 2024 Jaroslav Pevno, MiniaudioCpp is offered under the terms of the ISC license:
+//
+//   Permission to use, copy, modify, and/or distribute this software for any purpose with or
+//   without fee is hereby granted, provided that the above copyright notice and this permission
+//   notice appear in all copies. THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+//   WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+//   AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+//   CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+//   WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+//   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#pragma once
+
+#include "Core.h"
+#include "MiniaudioWrappers.h"
+
+#include <memory>
+#include <vector>
+
+namespace JPL
+{
+	//==========================================================================
+	/// Fixed number of preinitialized instances of a single sound asset.
+	///
+	/// All of the instances are created up front as copies of the first one,
+	/// sharing its decoded data, so triggering a sound doesn't allocate,
+	/// open a file, or set up a decoder.
+	/// Instances that reached their end are reclaimed automatically
+	/// when there are no free instances left, or on Update.
+	///
+	/// Meant for short rapid-fire one-shots like footsteps, impacts and gunshots.
+	/// Looping instances never reach their end, they must be returned with Release.
+	///
+	/// Game thread only.
+	///
+	/// Usage:
+	///		SoundPool footsteps;
+	///		footsteps.Init(engine, "footstep.wav", 8);
+	///		...
+	///		if (Sound* sound = footsteps.Play())
+	///			sound->SetPitch(randomPitch);
+	class SoundPool
+	{
+	public:
+		SoundPool() = default;
+
+		// Instances are handed out by pointer, so the pool can't be moved or copied
+		SoundPool(const SoundPool&) = delete;
+		SoundPool& operator=(const SoundPool&) = delete;
+
+		// Load the asset and create 'capacity' instances of it.
+		// MA_SOUND_FLAG_DECODE is added to 'flags', streamed sounds can't be shared.
+		bool Init(Engine& engine, const char* filePathOrId, uint32 capacity, uint32 flags = 0);
+		bool IsInitialized() const { return mCapacity > 0; }
+
+		// Take a free instance, rewound and reset to the default volume, pitch and no looping.
+		// The instance is reclaimed when it reaches its end after being started.
+		// @returns nullptr if all of the instances are in use
+		Sound* Acquire();
+
+		// Acquire and start an instance
+		Sound* Play();
+
+		// Stop the instance and return it to the pool
+		void Release(Sound& sound);
+
+		// Reclaim instances that reached their end
+		void Update();
+
+		// Stop all of the instances and return them to the pool
+		void StopAll();
+
+		uint32 GetCapacity() const { return mCapacity; }
+		uint32 GetNumFree() const { return static_cast<uint32>(mFreeInstances.size()); }
+		uint32 GetNumInUse() const { return static_cast<uint32>(mUsedInstances.size()); }
+
+	private:
+		// Index of the instance in mInstances, or -1 if the sound is not from this pool
+		int32_t FindInstance(const Sound& sound) const;
+
+		void ReleaseUsed(uint32 usedIndex);
+
+	private:
+		Sound mSource;	// Owns the decoded data, never played
+		std::unique_ptr<Sound[]> mInstances;
+		uint32 mCapacity = 0;
+
+		// Indices into mInstances, preallocated to the capacity
+		std::vector<uint32> mFreeInstances;
+		std::vector<uint32> mUsedInstances;
+	};
+} // namespace JPL
@@ -0,0 +1,190 @@
+﻿//
+//      ██╗██████╗     ██╗     ██╗██████╗ ███████╗
+//      ██║██╔══██╗    ██║     ██║██╔══██╗██╔════╝		** MiniaudioCpp **
+//      ██║██████╔╝    ██║     ██║██████╔╝███████╗
+// ██   ██║██╔═══╝     ██║     ██║██╔══██╗╚════██║		https://github.com/Jaytheway/MiniaudioCpp
+// ╚█████╔╝██║         ███████╗██║██████╔╝███████║
+//  ╚════╝ ╚═╝         ╚══════╝╚═╝╚═════╝ ╚══════╝
+//
+//   Copyright 2024 Jaroslav Pevno, MiniaudioCpp is offered under the terms of the ISC license:
+//
+//   Permission to use, copy, modify, and/or distribute this software for any purpose with or
+//   without fee is hereby granted, provided that the above copyright notice and this permission
+//   notice appear in all copies. THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+//   WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+//   AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+//   CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+//   WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+//   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#pragma once
+
+#include "Core.h"
+#include "MiniaudioWrappers.h"
+
+#include <vector>
+
+namespace JPL
+{
+	//==========================================================================
+	/// Limits the number of sounds playing at the same time in an engine.
+	///
+	/// Sounds are started through the voice manager instead of Sound::Start.
+	/// When the global limit, or the limit of the sound's category, is reached,
+	/// the voice with the lowest priority is stolen to make room for the new one.
+	/// Between voices of the same priority the quietest one is stolen, then the oldest.
+	/// If all of the candidates have higher priority than the new sound, the new sound is rejected.
+	///
+	/// Stolen voices are faded out over a short time and stopped, so stealing doesn't click.
+	/// Fading voices are still processed, their number is limited by MaxReleasingVoices,
+	/// beyond that voices are stopped immediately. So the number of sounds processed by the audio
+	/// thread never exceeds MaxVoices + MaxReleasingVoices.
+	///
+	/// Voices with volume at or below VirtualizeVolumeThreshold become virtual (see Sound::Virtualize):
+	/// they are not decoded or mixed and don't count towards the limits, but keep their timeline.
+	/// Once audible again, they're devirtualized on Update if there is room for them, stealing
+	/// a voice of lower priority if needed. Non-looping virtual voices that run past their end are
+	/// left stopped at the end and no longer tracked.
+	/// At most MaxVoices + MaxVirtualVoices sounds are tracked, beyond that new sounds are rejected.
+	///
+	/// Storage is reserved by Init and SetCategoryLimit, so playing, stealing and updating don't allocate.
+	///
+	/// Game thread only. Sounds must stay at the same address while tracked,
+	/// call Remove before destroying or moving a sound that may still be playing.
+	///
+	/// Usage:
+	///		VoiceManager voices;
+	///		voices.Init(engine, { .MaxVoices = 64 });
+	///		voices.SetCategoryLimit(eFootsteps, 8);
+	///		voices.Play(sound, { .Priority = 10, .Category = eFootsteps });
+	///		...
+	///		voices.Update();	// once per frame
+	class VoiceManager
+	{
+	public:
+		struct VoiceSettings
+		{
+			uint32 MaxVoices = 64;
+			uint32 MaxReleasingVoices = 16;
+			uint32 MaxVirtualVoices = 64;			// On top of MaxVoices
+			uint32 StealFadeInMilliseconds = 10;	// 0 - stop stolen voices immediately
+
+			// Voices with volume at or below this are virtualized on Update instead of being mixed.
+			// Negative - don't virtualize automatically.
+			float VirtualizeVolumeThreshold = 0.0f;
+		};
+
+		struct VoiceParams
+		{
+			int32_t Priority = 0;		// Higher priority voices are stolen last
+			uint32 Category = 0;	// User defined, see SetCategoryLimit
+		};
+
+		VoiceManager() = default;
+		~VoiceManager();
+
+		VoiceManager(const VoiceManager&) = delete;
+		VoiceManager& operator=(const VoiceManager&) = delete;
+
+		bool Init(Engine& engine, const VoiceSettings& settings);
+		bool IsInitialized() const { return mEngine != nullptr; }
+
+		// Max number of voices of the category playing at the same time, 0 - only the global limit applies.
+		// Voices are only counted per category for the categories registered here, see GetNumVoices.
+		void SetCategoryLimit(uint32 category, uint32 maxVoices);
+		uint32 GetCategoryLimit(uint32 category) const;
+
+		// Start the sound from its current position, stealing a voice if the limit is reached.
+		// If the sound is already tracked, it's restarted with the new parameters.
+		// @returns false if the sound was rejected, or failed to start
+		bool Play(Sound& sound, const VoiceParams& params);
+		bool Play(Sound& sound) { return Play(sound, VoiceParams{}); }
+
+		// Stop the sound and stop tracking it, virtual sound is reattached
+		void Stop(Sound& sound);
+
+		// Stop tracking the sound without stopping it, virtual sound stays virtual
+		void Remove(Sound& sound);
+
+		// Stop tracking sounds that finished playing (virtual ones included) or faded out after being stolen,
+		// virtualize inaudible voices, and devirtualize the ones that became audible.
+		// Should be called regularly, e.g. once per frame.
+		void Update();
+
+		// Voices that are mixed, not counting the virtual and releasing ones
+		uint32 GetNumActiveVoices() const { return mNumRealVoices; }
+		uint32 GetNumVirtualVoices() const { return static_cast<uint32>(mVoices.size()) - mNumRealVoices; }
+		uint32 GetNumReleasingVoices() const { return static_cast<uint32>(mReleasingVoices.size()); }
+		// Active voices of the category, 0 if the category was not registered with SetCategoryLimit
+		uint32 GetNumVoices(uint32 category) const;
+
+		bool IsTracked(const Sound& sound) const;
+
+		uint64 GetNumStolen() const { return mNumStolen; }
+		uint64 GetNumRejected() const { return mNumRejected; }
+
+	private:
+		struct Voice
+		{
+			Sound* Instance;
+			int32_t Priority;
+			uint32 Category;
+			uint64 StartTime;	// Engine time in frames, to steal the oldest voice
+			bool bVirtual;
+		};
+
+		struct ReleasingVoice
+		{
+			Sound* Instance;
+			uint64 StopTime;
+		};
+
+		struct CategoryState
+		{
+			uint32 Category;
+			uint32 MaxVoices;
+			uint32 NumVoices;	// Not counting virtual voices
+		};
+
+		CategoryState* FindCategory(uint32 category);
+		const CategoryState* FindCategory(uint32 category) const;
+
+		bool IsCategoryFull(const CategoryState& category) const { return category.MaxVoices > 0 && category.NumVoices >= category.MaxVoices; }
+		bool IsFull() const { return mVoices.size() >= mSettings.MaxVoices + mSettings.MaxVirtualVoices; }
+		bool IsInaudible(const Sound& sound) const { return mSettings.VirtualizeVolumeThreshold >= 0.0f && sound.GetVolume() <= mSettings.VirtualizeVolumeThreshold; }
+
+		// Steal a voice if there is no room for a new voice with 'params'.
+		// Voices of the same priority are only stolen if 'bStealEqualPriority' is true.
+		// @returns false if there is no room and no voice can be stolen
+		bool MakeRoom(const VoiceParams& params, bool bStealEqualPriority);
+
+		// Index of the voice to steal for a new voice with 'params', -1 if none can be stolen.
+		// If 'bSameCategory' is true, only voices of the same category are considered.
+		int32_t FindVoiceToSteal(const VoiceParams& params, bool bSameCategory, bool bStealEqualPriority) const;
+
+		void StealVoice(uint32 voiceIndex);
+		void RemoveVoice(uint32 voiceIndex);
+		void SetVoiceVirtual(Voice& voice, bool bVirtual);
+
+		// Devirtualize the voice if there is room for it
+		void TryDevirtualize(Sound& sound);
+
+		// Hard stop a releasing voice and undo the fade out and scheduled stop
+		void FinishReleasing(uint32 releasingIndex);
+
+	private:
+		Engine* mEngine = nullptr;
+		VoiceSettings mSettings;
+		uint64 mStealFadeInFrames = 0;
+
+		// Preallocated to the limits, so playing, stealing and updating doesn't allocate
+		std::vector<Voice> mVoices;
+		std::vector<ReleasingVoice> mReleasingVoices;
+		std::vector<CategoryState> mCategories;
+		std::vector<Sound*> mDevirtualizeQueue;
+		uint32 mNumRealVoices = 0;
+
+		uint64 mNumStolen = 0;
+		uint64 mNumRejected = 0;
+	};
+} // namespace JPL
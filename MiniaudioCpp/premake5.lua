@@ -56,3 +56,17 @@
 			optimize "off"
 			defines { "JPL_TEST" }
 
+		-- DSP kernels are additionally compiled for AVX2 and AVX-512, and selected at runtime, see DSP.cpp.
+		-- Only the kernel files get the wider instruction sets, nothing else may be compiled with them.
+		filter { "files:src/MiniAudioInterface/DSPKernels_AVX2.cpp", "system:windows" }
+			buildoptions { "/arch:AVX2" }
+
+		filter { "files:src/MiniAudioInterface/DSPKernels_AVX2.cpp", "system:not windows" }
+			buildoptions { "-mavx2", "-mfma" }
+
+		filter { "files:src/MiniAudioInterface/DSPKernels_AVX512.cpp", "system:windows" }
+			buildoptions { "/arch:AVX512" }
+
+		filter { "files:src/MiniAudioInterface/DSPKernels_AVX512.cpp", "system:not windows" }
+			buildoptions { "-mavx512f", "-mavx512dq", "-mavx512vl", "-mavx2", "-mfma" }
+
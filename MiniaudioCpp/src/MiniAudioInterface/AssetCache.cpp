@@ -0,0 +1,375 @@
+﻿//
+//      ██╗██████╗     ██╗     ██╗██████╗ ███████╗
+//      ██║██╔══██╗    ██║     ██║██╔══██╗██╔════╝		** MiniaudioCpp **
+//      ██║██████╔╝    ██║     ██║██████╔╝███████╗
+// ██   ██║██╔═══╝     ██║     ██║██╔══██╗╚════██║		https://github.com/Jaytheway/MiniaudioCpp
+// ╚█████╔╝██║         ███████╗██║██████╔╝███████║
+//  ╚════╝ ╚═╝         ╚══════╝╚═╝╚═════╝ ╚══════╝
+//
+//   Copyright 2024 Jaroslav Pevno, MiniaudioCpp is offered under the terms of the ISC license:
+//
+//   Permission to use, copy, modify, and/or distribute this software for any purpose with or
+//   without fee is hereby granted, provided that the above copyright notice and this permission
+//   notice appear in all copies. THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+//   WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+//   AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+//   CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+//   WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+//   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#include "AssetCache.h"
+
+#include "ErrorReporting.h"
+
+#include <format>
+#include <utility>
+
+namespace JPL
+{
+	//==========================================================================
+	AssetCache::Handle::Handle(const Handle& other)
+		: mCache(other.mCache)
+		, mAsset(other.mAsset)
+	{
+		if (mAsset)
+		{
+			std::scoped_lock lock(mCache->mMutex);
+			mCache->AddRef(*mAsset);
+		}
+	}
+
+	AssetCache::Handle& AssetCache::Handle::operator=(const Handle& other)
+	{
+		if (this != &other)
+		{
+			Handle copy(other);
+			*this = std::move(copy);
+		}
+		return *this;
+	}
+
+	AssetCache::Handle::Handle(Handle&& other) noexcept
+		: mCache(std::exchange(other.mCache, nullptr))
+		, mAsset(std::exchange(other.mAsset, nullptr))
+	{
+	}
+
+	AssetCache::Handle& AssetCache::Handle::operator=(Handle&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Reset();
+			mCache = std::exchange(other.mCache, nullptr);
+			mAsset = std::exchange(other.mAsset, nullptr);
+		}
+		return *this;
+	}
+
+	void AssetCache::Handle::Reset()
+	{
+		if (mAsset)
+		{
+			std::scoped_lock lock(mCache->mMutex);
+			mCache->Release(*mAsset);
+		}
+
+		mCache = nullptr;
+		mAsset = nullptr;
+	}
+
+	std::span<const float> AssetCache::Handle::GetData() const
+	{
+		return mAsset ? std::span<const float>(mAsset->Data, mAsset->NumFrames * mAsset->NumChannels) : std::span<const float>();
+	}
+
+	uint32 AssetCache::Handle::GetNumChannels() const { return mAsset ? mAsset->NumChannels : 0; }
+	uint32 AssetCache::Handle::GetSampleRate() const { return mAsset ? mAsset->SampleRate : 0; }
+	uint64 AssetCache::Handle::GetLengthInFrames() const { return mAsset ? mAsset->NumFrames : 0; }
+
+	//==========================================================================
+	AssetCache::~AssetCache()
+	{
+		for (auto& [key, asset] : mAssets)
+		{
+			JPL_ASSERT(asset->RefCount == 0, "Cached asset is still referenced.");
+			ma_free(asset->Data, &mAllocationCallbacks);
+		}
+	}
+
+	bool AssetCache::Init(Engine& engine, const CacheSettings& settings)
+	{
+		if (!JPL_ENSURE(!IsInitialized(), "AssetCache is already initialized."))
+			return false;
+
+		if (!engine)
+			return false;
+
+		ma_resource_manager* resourceManager = ma_engine_get_resource_manager(engine.get());
+		if (!JPL_ENSURE(resourceManager, "AssetCache requires the engine to have a resource manager."))
+			return false;
+
+		mEngine = &engine;
+		mSettings = settings;
+		mVFS = resourceManager->config.pVFS;
+		mAllocationCallbacks = engine.get()->allocationCallbacks;
+		return true;
+	}
+
+	//==========================================================================
+	AssetCache::Handle AssetCache::Load(std::string_view filePathOrId)
+	{
+		if (!JPL_ENSURE(IsInitialized(), "AssetCache is not initialized."))
+			return {};
+
+		std::scoped_lock lock(mMutex);
+		Asset* asset = LoadLocked(filePathOrId);
+		if (!asset)
+			return {};
+
+		AddRef(*asset);
+		return Handle(this, asset);
+	}
+
+	bool AssetCache::Pin(std::string_view filePathOrId)
+	{
+		if (!JPL_ENSURE(IsInitialized(), "AssetCache is not initialized."))
+			return false;
+
+		std::scoped_lock lock(mMutex);
+		Asset* asset = LoadLocked(filePathOrId);
+		if (!asset)
+			return false;
+
+		if (IsEvictable(*asset))
+			RemoveFromLRU(*asset);
+
+		asset->bPinned = true;
+		return true;
+	}
+
+	void AssetCache::Unpin(std::string_view filePathOrId)
+	{
+		std::scoped_lock lock(mMutex);
+
+		auto it = mAssets.find(filePathOrId);
+		if (it == mAssets.end() || !it->second->bPinned)
+			return;
+
+		Asset& asset = *it->second;
+		asset.bPinned = false;
+		if (IsEvictable(asset))
+			AddToLRU(asset);
+
+		// May have been kept over a budget lowered while pinned
+		MakeRoom(0);
+	}
+
+	void AssetCache::SetBudget(uint64 budgetInBytes)
+	{
+		std::scoped_lock lock(mMutex);
+		mSettings.BudgetInBytes = budgetInBytes;
+		MakeRoom(0);
+	}
+
+	uint64 AssetCache::GetBudget() const
+	{
+		std::scoped_lock lock(mMutex);
+		return mSettings.BudgetInBytes;
+	}
+
+	void AssetCache::Trim()
+	{
+		std::scoped_lock lock(mMutex);
+		while (!mLRU.empty())
+			Evict(*mLRU.back());
+	}
+
+	bool AssetCache::IsCached(std::string_view filePathOrId) const
+	{
+		std::scoped_lock lock(mMutex);
+		return mAssets.contains(filePathOrId);
+	}
+
+	uint64 AssetCache::GetUsedBytes() const { std::scoped_lock lock(mMutex); return mUsedBytes; }
+	uint32 AssetCache::GetNumAssets() const { std::scoped_lock lock(mMutex); return static_cast<uint32>(mAssets.size()); }
+	uint64 AssetCache::GetNumHits() const { std::scoped_lock lock(mMutex); return mNumHits; }
+	uint64 AssetCache::GetNumMisses() const { std::scoped_lock lock(mMutex); return mNumMisses; }
+	uint64 AssetCache::GetNumEvictions() const { std::scoped_lock lock(mMutex); return mNumEvictions; }
+
+	//==========================================================================
+	AssetCache::Asset* AssetCache::LoadLocked(std::string_view filePathOrId)
+	{
+		if (auto it = mAssets.find(filePathOrId); it != mAssets.end())
+		{
+			++mNumHits;
+			return it->second.get();
+		}
+
+		++mNumMisses;
+
+		auto asset = std::make_unique<Asset>();
+		asset->Key = filePathOrId;
+
+		// Native channel count and sample rate, the sound converts them if needed
+		ma_decoder_config config = ma_decoder_config_init(ma_format_f32, 0, 0);
+		config.allocationCallbacks = mAllocationCallbacks;
+
+		auto reportNoRoom = [this, &asset](uint64 sizeInBytes)
+		{
+			JPL_ERROR_TAG("AssetCache", std::format("'{}' doesn't fit the budget, {} bytes are used out of {}, {} of them evictable, {} bytes requested.",
+													asset->Key, mUsedBytes, mSettings.BudgetInBytes, mEvictableBytes, sizeInBytes));
+		};
+
+		// Don't decode assets that can't fit, if the decoder knows the length up front
+		{
+			ma_decoder decoder;
+			ma_result result = ma_decoder_init_vfs(mVFS, asset->Key.c_str(), &config, &decoder);
+			if (result != MA_SUCCESS)
+			{
+				JPL_ERROR_TAG("AssetCache", std::format("Failed to decode '{}': {}", asset->Key, ma_result_description(result)));
+				return nullptr;
+			}
+
+			ma_uint64 lengthInFrames = 0;
+			result = ma_decoder_get_length_in_pcm_frames(&decoder, &lengthInFrames);
+			const uint64 sizeInBytes = lengthInFrames * decoder.outputChannels * sizeof(float);
+			ma_decoder_uninit(&decoder);
+
+			if (result == MA_SUCCESS && lengthInFrames > 0 && !CanFit(sizeInBytes))
+			{
+				reportNoRoom(sizeInBytes);
+				return nullptr;
+			}
+		}
+
+		void* data = nullptr;
+		ma_uint64 numFrames = 0;
+		const ma_result result = ma_decode_from_vfs(mVFS, asset->Key.c_str(), &config, &numFrames, &data);
+		if (result != MA_SUCCESS)
+		{
+			JPL_ERROR_TAG("AssetCache", std::format("Failed to decode '{}': {}", asset->Key, ma_result_description(result)));
+			return nullptr;
+		}
+
+		asset->Data = static_cast<float*>(data);
+		asset->NumFrames = numFrames;
+		asset->NumChannels = config.channels;
+		asset->SampleRate = config.sampleRate;
+		asset->SizeInBytes = numFrames * config.channels * sizeof(float);
+
+		// Check before evicting, so a load that fails doesn't empty the cache
+		if (!CanFit(asset->SizeInBytes) || !MakeRoom(asset->SizeInBytes))
+		{
+			reportNoRoom(asset->SizeInBytes);
+			ma_free(asset->Data, &mAllocationCallbacks);
+			return nullptr;
+		}
+
+		mUsedBytes += asset->SizeInBytes;
+
+		// Not evictable, the caller either references or pins it right away
+		Asset* loadedAsset = asset.get();
+		mAssets.emplace(loadedAsset->Key, std::move(asset));
+		return loadedAsset;
+	}
+
+	void AssetCache::AddRef(Asset& asset)
+	{
+		if (IsEvictable(asset))
+			RemoveFromLRU(asset);
+
+		++asset.RefCount;
+	}
+
+	void AssetCache::Release(Asset& asset)
+	{
+		JPL_ASSERT(asset.RefCount > 0);
+		--asset.RefCount;
+
+		if (IsEvictable(asset))
+		{
+			AddToLRU(asset);
+
+			// May have been kept over a budget lowered while referenced
+			MakeRoom(0);
+		}
+	}
+
+	bool AssetCache::MakeRoom(uint64 sizeInBytes)
+	{
+		while (mUsedBytes + sizeInBytes > mSettings.BudgetInBytes && !mLRU.empty())
+			Evict(*mLRU.back());
+
+		return mUsedBytes + sizeInBytes <= mSettings.BudgetInBytes;
+	}
+
+	void AssetCache::AddToLRU(Asset& asset)
+	{
+		asset.LRUPosition = mLRU.insert(mLRU.begin(), &asset);
+		mEvictableBytes += asset.SizeInBytes;
+	}
+
+	void AssetCache::RemoveFromLRU(Asset& asset)
+	{
+		mLRU.erase(asset.LRUPosition);
+		mEvictableBytes -= asset.SizeInBytes;
+	}
+
+	void AssetCache::Evict(Asset& asset)
+	{
+		JPL_ASSERT(IsEvictable(asset));
+
+		RemoveFromLRU(asset);
+		mUsedBytes -= asset.SizeInBytes;
+		++mNumEvictions;
+
+		ma_free(asset.Data, &mAllocationCallbacks);
+
+		// Key is owned by the asset, find it before erasing
+		auto it = mAssets.find(asset.Key);
+		mAssets.erase(it);
+	}
+
+	//==========================================================================
+	bool CachedSound::Init(AssetCache& cache, std::string_view filePathOrId, uint32_t flags)
+	{
+		Uninit();
+
+		if (!cache.IsInitialized())
+			return false;
+
+		mAsset = cache.Load(filePathOrId);
+		if (!mAsset)
+			return false;
+
+		const std::span<const float> data = mAsset.GetData();
+		if (ma_audio_buffer_ref_init(ma_format_f32, mAsset.GetNumChannels(), data.data(), mAsset.GetLengthInFrames(), &mBufferRef) != MA_SUCCESS)
+		{
+			mAsset.Reset();
+			return false;
+		}
+
+		// Buffer ref doesn't know the sample rate, without it the sound would play at the engine's rate
+		mBufferRef.sampleRate = mAsset.GetSampleRate();
+
+		if (!mSound.InitFromDataSource(*cache.GetEngine(), &mBufferRef, flags))
+		{
+			ma_audio_buffer_ref_uninit(&mBufferRef);
+			mAsset.Reset();
+			return false;
+		}
+
+		return true;
+	}
+
+	void CachedSound::Uninit()
+	{
+		if (!mAsset)
+			return;
+
+		// Sound reads from the buffer, it must go first
+		mSound.clear();
+		ma_audio_buffer_ref_uninit(&mBufferRef);
+		mAsset.Reset();
+	}
+} // namespace JPL
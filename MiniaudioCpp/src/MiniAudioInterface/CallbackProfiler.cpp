@@ -0,0 +1,126 @@
+﻿//
+//      ██╗██████╗     ██╗     ██╗██████╗ ███████╗
+//      ██║██╔══██╗    ██║     ██║██╔══██╗██╔════╝		** MiniaudioCpp **
+//      ██║██████╔╝    ██║     ██║██████╔╝███████╗
+// ██   ██║██╔═══╝     ██║     ██║██╔══██╗╚════██║		https://github.com/Jaytheway/MiniaudioCpp
+// ╚█████╔╝██║         ███████╗██║██████╔╝███████║
+//  ╚════╝ ╚═╝         ╚══════╝╚═╝╚═════╝ ╚══════╝
+//
+//   Copyright 2024 Jaroslav Pevno, MiniaudioCpp is offered under the terms of the ISC license:
+//
+//   Permission to use, copy, modify, and/or distribute this software for any purpose with or
+//   without fee is hereby granted, provided that the above copyright notice and this permission
+//   notice appear in all copies. THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+//   WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+//   AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+//   CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+//   WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+//   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#include "CallbackProfiler.h"
+
+namespace JPL
+{
+	namespace
+	{
+		// Single writer, so there is no need for CAS loops
+		template<class T>
+		JPL_INLINE void StoreMax(std::atomic<T>& target, T value)
+		{
+			if (value > target.load(std::memory_order_relaxed))
+				target.store(value, std::memory_order_relaxed);
+		}
+
+		template<class T>
+		JPL_INLINE void StoreAdd(std::atomic<T>& target, T value)
+		{
+			target.store(target.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+		}
+	}
+
+	void CallbackProfiler::BeginCallback()
+	{
+		if (mResetRequested.load(std::memory_order_acquire))
+			ResetOnAudioThread();
+
+		mCallbackStart = Clock::now();
+
+		if (mPreviousBlockDurationNs > 0)
+		{
+			// Ideally callbacks are spaced exactly by the duration of the previous block
+			const int64_t intervalNs = std::chrono::duration_cast<std::chrono::nanoseconds>(mCallbackStart - mPreviousCallbackStart).count();
+			const uint64 jitterNs = static_cast<uint64>(std::abs(intervalNs - mPreviousBlockDurationNs));
+
+			mJitterUs.Add(static_cast<double>(jitterNs) * 1e-3);
+			StoreMax(mPeakJitterNs, jitterNs);
+		}
+
+		mPreviousCallbackStart = mCallbackStart;
+	}
+
+	void CallbackProfiler::EndCallback(uint32 numFrames, uint32 sampleRate)
+	{
+		const Clock::time_point callbackEnd = Clock::now();
+
+		const uint64 processingNs = static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(callbackEnd - mCallbackStart).count());
+		const uint64 blockDurationNs = sampleRate > 0 ? static_cast<uint64>(numFrames) * 1'000'000'000ull / sampleRate : 0;
+		mPreviousBlockDurationNs = static_cast<int64_t>(blockDurationNs);
+
+		mProcessingTimeUs.Add(static_cast<double>(processingNs) * 1e-3);
+		StoreMax(mPeakProcessingNs, processingNs);
+
+		StoreAdd(mTotalProcessingNs, processingNs);
+		StoreAdd(mTotalBlockDurationNs, blockDurationNs);
+
+		if (blockDurationNs > 0)
+		{
+			const double loadPercent = 100.0 * static_cast<double>(processingNs) / static_cast<double>(blockDurationNs);
+			mLoadPercent.Add(loadPercent);
+			mLastLoadPercent.store(loadPercent, std::memory_order_relaxed);
+			StoreMax(mPeakLoadPercent, loadPercent);
+
+			if (processingNs > blockDurationNs)
+				StoreAdd(mNumDeadlineMisses, uint64(1));
+		}
+
+		// Published last, so that a reader seeing the count sees stats for at least as many callbacks
+		mNumCallbacks.store(mNumCallbacks.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	CallbackProfiler::Snapshot CallbackProfiler::GetSnapshot() const
+	{
+		Snapshot snapshot;
+		snapshot.NumCallbacks = mNumCallbacks.load(std::memory_order_acquire);
+		snapshot.NumDeadlineMisses = mNumDeadlineMisses.load(std::memory_order_relaxed);
+		snapshot.LastLoadPercent = mLastLoadPercent.load(std::memory_order_relaxed);
+		snapshot.PeakLoadPercent = mPeakLoadPercent.load(std::memory_order_relaxed);
+		snapshot.PeakProcessingTimeUs = static_cast<double>(mPeakProcessingNs.load(std::memory_order_relaxed)) * 1e-3;
+		snapshot.PeakJitterUs = static_cast<double>(mPeakJitterNs.load(std::memory_order_relaxed)) * 1e-3;
+
+		const uint64 totalBlockDurationNs = mTotalBlockDurationNs.load(std::memory_order_relaxed);
+		if (totalBlockDurationNs > 0)
+			snapshot.AverageLoadPercent = 100.0 * static_cast<double>(mTotalProcessingNs.load(std::memory_order_relaxed)) / static_cast<double>(totalBlockDurationNs);
+
+		return snapshot;
+	}
+
+	void CallbackProfiler::ResetOnAudioThread()
+	{
+		mProcessingTimeUs.Reset();
+		mJitterUs.Reset();
+		mLoadPercent.Reset();
+
+		mPreviousBlockDurationNs = 0;
+
+		mNumCallbacks.store(0, std::memory_order_relaxed);
+		mNumDeadlineMisses.store(0, std::memory_order_relaxed);
+		mTotalProcessingNs.store(0, std::memory_order_relaxed);
+		mTotalBlockDurationNs.store(0, std::memory_order_relaxed);
+		mPeakProcessingNs.store(0, std::memory_order_relaxed);
+		mPeakJitterNs.store(0, std::memory_order_relaxed);
+		mLastLoadPercent.store(0.0, std::memory_order_relaxed);
+		mPeakLoadPercent.store(0.0, std::memory_order_relaxed);
+
+		mResetRequested.store(false, std::memory_order_release);
+	}
+} // namespace JPL
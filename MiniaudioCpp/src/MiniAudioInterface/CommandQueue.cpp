@@ -0,0 +1,187 @@
+﻿//
+//      ██╗██████╗     ██╗     ██╗██████╗ ███████╗
+//      ██║██╔══██╗    ██║     ██║██╔══██╗██╔════╝		** MiniaudioCpp **
+//      ██║██████╔╝    ██║     ██║██████╔╝███████╗
+// ██   ██║██╔═══╝     ██║     ██║██╔══██╗╚════██║		https://github.com/Jaytheway/MiniaudioCpp
+// ╚█████╔╝██║         ███████╗██║██████╔╝███████║
+//  ╚════╝ ╚═╝         ╚══════╝╚═╝╚═════╝ ╚══════╝
+//
+//   Copyright 2024 Jaroslav Pevno, MiniaudioCpp is offered under the terms of the ISC license:
+//
+//   Permission to use, copy, modify, and/or distribute this software for any purpose with or
+//   without fee is hereby granted, provided that the above copyright notice and this permission
+//   notice appear in all copies. THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+//   WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+//   AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+//   CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+//   WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+//   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#include "CommandQueue.h"
+
+#include "ErrorReporting.h"
+
+#include "c89atomic.h"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <thread>
+
+namespace JPL
+{
+	//==========================================================================
+	void ParameterCommand::Apply() const
+	{
+		switch (Type)
+		{
+			case EType::SoundVolume:
+				ma_sound_set_volume(static_cast<ma_sound*>(Target), static_cast<float>(Value));
+				break;
+			case EType::SoundPitch:
+				ma_sound_set_pitch(static_cast<ma_sound*>(Target), static_cast<float>(Value));
+				break;
+			case EType::GroupPitch:
+				// See EngineNode::SetPitch
+				c89atomic_exchange_explicit_f32(&static_cast<ma_engine_node*>(Target)->pitch, static_cast<float>(Value), c89atomic_memory_order_release);
+				break;
+			case EType::BusVolume:
+				ma_node_set_output_bus_volume(static_cast<ma_node_base*>(Target), Index, static_cast<float>(Value));
+				break;
+			case EType::LPFCutoff:
+			{
+				auto* node = static_cast<ma_lpf_node*>(Target);
+				const ma_lpf_config config = ma_lpf_config_init(node->lpf.format, node->lpf.channels, node->lpf.sampleRate, Value, Index);
+				[[maybe_unused]] ma_result result = ma_lpf_node_reinit(&config, node);
+				JPL_ASSERT(result == MA_SUCCESS);
+				break;
+			}
+			case EType::HPFCutoff:
+			{
+				auto* node = static_cast<ma_hpf_node*>(Target);
+				const ma_hpf_config config = ma_hpf_config_init(node->hpf.format, node->hpf.channels, node->hpf.sampleRate, Value, Index);
+				[[maybe_unused]] ma_result result = ma_hpf_node_reinit(&config, node);
+				JPL_ASSERT(result == MA_SUCCESS);
+				break;
+			}
+			case EType::SoundStart:
+			{
+				// Same as Sound::StartAtFrame
+				auto* sound = static_cast<ma_sound*>(Target);
+				ma_sound_set_stop_time_in_pcm_frames(sound, std::numeric_limits<ma_uint64>::max());
+				ma_sound_set_start_time_in_pcm_frames(sound, Time);
+				ma_sound_start(sound);
+				break;
+			}
+			case EType::SoundStop:
+				ma_sound_set_stop_time_with_fade_in_pcm_frames(static_cast<ma_sound*>(Target), Time, Index);
+				break;
+			default:
+				JPL_ASSERT(false, "Unknown parameter command.");
+		}
+	}
+
+	//==========================================================================
+	void CommandBatch::SetVolume(Sound& sound, float volume)
+	{
+		if (ma_sound* target = sound.get())
+			mCommands.push_back({ ParameterCommand::EType::SoundVolume, 0, target, volume });
+	}
+
+	void CommandBatch::SetPitch(Sound& sound, float pitch)
+	{
+		if (ma_sound* target = sound.get())
+			mCommands.push_back({ ParameterCommand::EType::SoundPitch, 0, target, pitch });
+	}
+
+	void CommandBatch::SetPitch(EngineNode& group, float pitch)
+	{
+		// Same as EngineNode::SetPitch
+		if (pitch <= 0)
+			return;
+
+		if (ma_engine_node* target = group.get())
+			mCommands.push_back({ ParameterCommand::EType::GroupPitch, 0, target, pitch });
+	}
+
+	void CommandBatch::SetVolume(OutputBus bus, float volume)
+	{
+		if (bus.IsValid())
+			mCommands.push_back({ ParameterCommand::EType::BusVolume, bus.GetIndex(), bus.GetMaOwner(), volume });
+	}
+
+	void CommandBatch::SetCutoffFrequency(LPFNode& lpf, double cutoffFrequency)
+	{
+		if (ma_lpf_node* target = lpf.get())
+		{
+			lpf.mCutoffFrequency = cutoffFrequency;
+			mCommands.push_back({ ParameterCommand::EType::LPFCutoff, lpf.GetOrder(), target, cutoffFrequency });
+		}
+	}
+
+	void CommandBatch::SetCutoffFrequency(HPFNode& hpf, double cutoffFrequency)
+	{
+		if (ma_hpf_node* target = hpf.get())
+		{
+			hpf.mCutoffFrequency = cutoffFrequency;
+			mCommands.push_back({ ParameterCommand::EType::HPFCutoff, hpf.GetOrder(), target, cutoffFrequency });
+		}
+	}
+
+	void CommandBatch::ScheduleStart(Sound& sound, uint64 engineTimeInFrames)
+	{
+		if (ma_sound* target = sound.get())
+		{
+			mCommands.push_back({ ParameterCommand::EType::SoundStart, 0, target });
+			mCommands.back().Time = engineTimeInFrames;
+		}
+	}
+
+	void CommandBatch::ScheduleStop(Sound& sound, uint64 engineTimeInFrames, uint32 fadeLengthInFrames)
+	{
+		if (ma_sound* target = sound.get())
+		{
+			mCommands.push_back({ ParameterCommand::EType::SoundStop, fadeLengthInFrames, target });
+			mCommands.back().Time = engineTimeInFrames;
+		}
+	}
+
+	//==========================================================================
+	CommandQueue::CommandQueue(uint32 capacity)
+		: mCommands(std::make_unique<ParameterCommand[]>(std::bit_ceil(std::max(capacity, 1u))))
+		, mMask(std::bit_ceil(std::max(capacity, 1u)) - 1)
+	{
+	}
+
+	bool CommandQueue::Push(std::span<const ParameterCommand> commands)
+	{
+		if (commands.empty())
+			return true;
+
+		const uint64 numCommands = commands.size();
+		if (numCommands > GetCapacity())
+			return false;
+
+		// Reserve space for the whole batch
+		uint64 begin = mReserveIndex.load(std::memory_order_relaxed);
+		do
+		{
+			if (begin + numCommands - mReadIndex.load(std::memory_order_acquire) > GetCapacity())
+				return false;
+		}
+		while (!mReserveIndex.compare_exchange_weak(begin, begin + numCommands, std::memory_order_relaxed));
+
+		for (uint64 i = 0; i < numCommands; ++i)
+			mCommands[(begin + i) & mMask] = commands[i];
+
+		// Wait for the producers that reserved before us to commit, to keep committed range contiguous
+		uint64 expected = begin;
+		while (!mCommitIndex.compare_exchange_weak(expected, begin + numCommands, std::memory_order_release, std::memory_order_relaxed))
+		{
+			expected = begin;
+			std::this_thread::yield();
+		}
+
+		return true;
+	}
+} // namespace JPL
@@ -0,0 +1,249 @@
+#include "DSP.h"
+#include "DSPKernels.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+#if defined(JPL_CPU_X86)
+#if defined(JPL_COMPILER_MSVC)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace JPL::DSP
+{
+	namespace Internal
+	{
+		namespace
+		{
+			// Fallback for CPUs without a supported vector instruction set
+			struct VecScalar
+			{
+				using Type = float;
+				static constexpr uint32 Width = 1;
+
+				static JPL_INLINE Type Load(const float* p) { return *p; }
+				static JPL_INLINE void Store(float* p, Type v) { *p = v; }
+				static JPL_INLINE Type Set(float value) { return value; }
+				static JPL_INLINE Type Add(Type a, Type b) { return a + b; }
+				static JPL_INLINE Type Mul(Type a, Type b) { return a * b; }
+				static JPL_INLINE Type MulAdd(Type a, Type b, Type c) { return a * b + c; }
+				static JPL_INLINE Type Min(Type a, Type b) { return a < b ? a : b; }
+				static JPL_INLINE Type Max(Type a, Type b) { return a > b ? a : b; }
+				static JPL_INLINE Type Abs(Type v) { return std::fabs(v); }
+				static JPL_INLINE float ReduceMax(Type v) { return v; }
+
+				static JPL_INLINE void DeinterleaveStereo(const float* frames, float* left, float* right) { *left = frames[0]; *right = frames[1]; }
+				static JPL_INLINE void InterleaveStereo(const float* left, const float* right, float* frames) { frames[0] = *left; frames[1] = *right; }
+			};
+
+			constexpr Kernels sKernelsScalar = TKernels<VecScalar>::GetTable("Scalar");
+		}
+
+		const Kernels* GetKernelsScalar() { return &sKernelsScalar; }
+	}
+
+	namespace
+	{
+		//======================================================================
+		// Host CPU features, regardless of what the library was compiled with
+
+#if defined(JPL_CPU_X86)
+		void CPUID(uint32 leaf, uint32 subleaf, uint32 (&registers)[4])
+		{
+#if defined(JPL_COMPILER_MSVC)
+			int result[4];
+			__cpuidex(result, static_cast<int>(leaf), static_cast<int>(subleaf));
+			for (int i = 0; i < 4; ++i)
+				registers[i] = static_cast<uint32>(result[i]);
+#else
+			__cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+		}
+
+		// Register state the OS saves on context switches
+		uint64 GetEnabledXSaveFeatures()
+		{
+#if defined(JPL_COMPILER_MSVC)
+			return _xgetbv(0);
+#else
+			uint32 eax, edx;
+			__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+			return (static_cast<uint64>(edx) << 32) | eax;
+#endif
+		}
+#endif
+
+		bool IsSupportedByHost(EInstructionSet instructionSet)
+		{
+			switch (instructionSet)
+			{
+			case EInstructionSet::Scalar:
+				return true;
+
+#if defined(JPL_CPU_X86)
+			case EInstructionSet::SSE2:
+			{
+				uint32 regs[4];
+				CPUID(1, 0, regs);
+				return (regs[3] & (1u << 26)) != 0;
+			}
+			case EInstructionSet::AVX2:
+			case EInstructionSet::AVX512:
+			{
+				uint32 regs[4];
+				CPUID(0, 0, regs);
+				if (regs[0] < 7)
+					return false;
+
+				CPUID(1, 0, regs);
+				const bool bOSXSave = (regs[2] & (1u << 27)) != 0;
+				const bool bAVX = (regs[2] & (1u << 28)) != 0;
+				const bool bFMA = (regs[2] & (1u << 12)) != 0;
+				if (!bOSXSave || !bAVX || !bFMA)
+					return false;
+
+				CPUID(7, 0, regs);
+				const uint64 xcr0 = GetEnabledXSaveFeatures();
+
+				// XMM and YMM state
+				const bool bAVX2 = (regs[1] & (1u << 5)) != 0 && (xcr0 & 0x6) == 0x6;
+				if (instructionSet == EInstructionSet::AVX2)
+					return bAVX2;
+
+				// F, DQ, VL, and opmask, upper ZMM and high ZMM state
+				const uint32 avx512Bits = (1u << 16) | (1u << 17) | (1u << 31);
+				return bAVX2 && (regs[1] & avx512Bits) == avx512Bits && (xcr0 & 0xe6) == 0xe6;
+			}
+#endif
+
+#if defined(JPL_USE_NEON)
+			case EInstructionSet::NEON:
+				return true;	// Mandatory on AArch64
+#endif
+
+			default:
+				return false;
+			}
+		}
+
+		const Internal::Kernels* GetKernels(EInstructionSet instructionSet)
+		{
+			switch (instructionSet)
+			{
+			case EInstructionSet::Scalar:	return Internal::GetKernelsScalar();
+			case EInstructionSet::SSE2:		return Internal::GetKernelsSSE2();
+			case EInstructionSet::AVX2:		return Internal::GetKernelsAVX2();
+			case EInstructionSet::AVX512:	return Internal::GetKernelsAVX512();
+			case EInstructionSet::NEON:		return Internal::GetKernelsNEON();
+			default:						return nullptr;
+			}
+		}
+
+		EInstructionSet SelectBestInstructionSet()
+		{
+			for (const EInstructionSet instructionSet : { EInstructionSet::AVX512, EInstructionSet::AVX2, EInstructionSet::SSE2, EInstructionSet::NEON })
+			{
+				if (IsSupported(instructionSet))
+					return instructionSet;
+			}
+			return EInstructionSet::Scalar;
+		}
+
+		struct Dispatch
+		{
+			std::atomic<const Internal::Kernels*> Kernels;
+			std::atomic<EInstructionSet> InstructionSet;
+
+			Dispatch()
+			{
+				const EInstructionSet best = SelectBestInstructionSet();
+				Kernels.store(GetKernels(best), std::memory_order_relaxed);
+				InstructionSet.store(best, std::memory_order_relaxed);
+			}
+		};
+
+		// Selected on first use, rather than during static initialization, so that it's valid for any caller
+		Dispatch& GetDispatch()
+		{
+			static Dispatch sDispatch;
+			return sDispatch;
+		}
+
+		JPL_INLINE const Internal::Kernels& K()
+		{
+			return *GetDispatch().Kernels.load(std::memory_order_relaxed);
+		}
+	}
+
+	//==========================================================================
+	bool IsSupported(EInstructionSet instructionSet)
+	{
+		return GetKernels(instructionSet) != nullptr && IsSupportedByHost(instructionSet);
+	}
+
+	EInstructionSet GetInstructionSet()
+	{
+		return GetDispatch().InstructionSet.load(std::memory_order_relaxed);
+	}
+
+	const char* GetInstructionSetName()
+	{
+		return K().Name;
+	}
+
+	bool SetInstructionSet(EInstructionSet instructionSet)
+	{
+		if (!IsSupported(instructionSet))
+			return false;
+
+		Dispatch& dispatch = GetDispatch();
+		dispatch.Kernels.store(GetKernels(instructionSet), std::memory_order_relaxed);
+		dispatch.InstructionSet.store(instructionSet, std::memory_order_relaxed);
+		return true;
+	}
+
+	void ResetInstructionSet()
+	{
+		SetInstructionSet(SelectBestInstructionSet());
+	}
+
+	//==========================================================================
+	// Copy and silence are left to the C library, which has its own dispatch
+
+	void Copy(const float* source, float* destination, uint32 numSamples)
+	{
+		std::memcpy(destination, source, numSamples * sizeof(float));
+	}
+
+	void Silence(float* destination, uint32 numSamples)
+	{
+		std::memset(destination, 0, numSamples * sizeof(float));
+	}
+
+	void Mix(const float* source, float* destination, uint32 numSamples) { K().Mix(source, destination, numSamples); }
+	void MixWithGain(const float* source, float* destination, uint32 numSamples, float gain) { K().MixWithGain(source, destination, numSamples, gain); }
+	void ApplyGain(float* samples, uint32 numSamples, float gain) { K().ApplyGain(samples, numSamples, gain); }
+	void ApplyGainRamp(float* samples, uint32 numChannels, uint32 numFrames, float startGain, float endGain) { K().ApplyGainRamp(samples, numChannels, numFrames, startGain, endGain); }
+	void Clamp(float* samples, uint32 numSamples, float minValue, float maxValue) { K().Clamp(samples, numSamples, minValue, maxValue); }
+	float FindPeak(const float* samples, uint32 numSamples) { return K().FindPeak(samples, numSamples); }
+
+	void Deinterleave(const float* interleaved, float* const* channels, uint32 numChannels, uint32 numFrames)
+	{
+		if (numChannels == 1)
+			Copy(interleaved, channels[0], numFrames);
+		else
+			K().Deinterleave(interleaved, channels, numChannels, numFrames);
+	}
+
+	void Interleave(const float* const* channels, float* interleaved, uint32 numChannels, uint32 numFrames)
+	{
+		if (numChannels == 1)
+			Copy(channels[0], interleaved, numFrames);
+		else
+			K().Interleave(channels, interleaved, numChannels, numFrames);
+	}
+} // namespace JPL::DSP
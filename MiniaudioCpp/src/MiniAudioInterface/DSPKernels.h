@@ -0,0 +1,237 @@
+﻿//
+//      ██╗██████╗     ██╗     ██╗██████╗ ███████╗
+//      ██║██╔══██╗    ██║     ██║██╔══██╗██╔════╝		** MiniaudioCpp **
+//      ██║██████╔╝    ██║     ██║██████╔╝███████╗
+// ██   ██║██╔═══╝     ██║     ██║██╔══██╗╚════██║		https://github.com/Jaytheway/MiniaudioCpp
+// ╚█████╔╝██║         ███████╗██║██████╔╝███████║
+//  ╚════╝ ╚═╝         ╚══════╝╚═╝╚═════╝ ╚══════╝
+//
+//   Copyright 2024 Jaroslav Pevno, MiniaudioCpp is offered under the terms of the ISC license:
+//
+//   Permission to use, copy, modify, and/or distribute this software for any purpose with or
+//   without fee is hereby granted, provided that the above copyright notice and this permission
+//   notice appear in all copies. THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+//   WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+//   AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+//   CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+//   WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+//   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#pragma once
+
+#include "Core.h"
+
+// Internal to DSP: kernels written once against a vector type, and compiled
+// in a separate translation unit per instruction set, see DSP.cpp.
+//
+// Each ISA translation unit defines its vector type in an anonymous namespace,
+// so that every instantiation of TKernels has internal linkage and code compiled
+// with wider instruction sets can't leak into the rest of the library through the linker.
+// For the same reason the kernels don't use inline functions from the standard library.
+
+namespace JPL::DSP::Internal
+{
+	//==========================================================================
+	/// Dispatch table of the kernels compiled for one instruction set
+	struct Kernels
+	{
+		const char* Name;
+		void (*Mix)(const float* source, float* destination, uint32 numSamples);
+		void (*MixWithGain)(const float* source, float* destination, uint32 numSamples, float gain);
+		void (*ApplyGain)(float* samples, uint32 numSamples, float gain);
+		void (*ApplyGainRamp)(float* samples, uint32 numChannels, uint32 numFrames, float startGain, float endGain);
+		void (*Clamp)(float* samples, uint32 numSamples, float minValue, float maxValue);
+		float (*FindPeak)(const float* samples, uint32 numSamples);
+		void (*Deinterleave)(const float* interleaved, float* const* channels, uint32 numChannels, uint32 numFrames);
+		void (*Interleave)(const float* const* channels, float* interleaved, uint32 numChannels, uint32 numFrames);
+	};
+
+	// @returns nullptr if the translation unit was not compiled for the instruction set
+	const Kernels* GetKernelsScalar();
+	const Kernels* GetKernelsSSE2();
+	const Kernels* GetKernelsAVX2();
+	const Kernels* GetKernelsAVX512();
+	const Kernels* GetKernelsNEON();
+
+	//==========================================================================
+	/// Vec must provide:
+	///		Type, Width,
+	///		Load, Store, Set, Add, Mul, MulAdd (a * b + c), Min, Max, Abs, ReduceMax,
+	///		DeinterleaveStereo and InterleaveStereo of 'Width' frames
+	template<class Vec>
+	struct TKernels
+	{
+		static constexpr uint32 Width = Vec::Width;
+		using V = typename Vec::Type;
+
+		static float MinScalar(float a, float b) { return a < b ? a : b; }
+		static float MaxScalar(float a, float b) { return a > b ? a : b; }
+		static float AbsScalar(float a) { return a < 0.0f ? -a : a; }
+
+		// Number of samples processed by the vector loops, the rest is left to the scalar tail
+		static uint32 GetVectorizedCount(uint32 numSamples) { return numSamples - numSamples % Width; }
+
+		static void Mix(const float* source, float* destination, uint32 numSamples)
+		{
+			const uint32 numVectorized = GetVectorizedCount(numSamples);
+
+			uint32 i = 0;
+			for (; i < numVectorized; i += Width)
+				Vec::Store(destination + i, Vec::Add(Vec::Load(destination + i), Vec::Load(source + i)));
+
+			for (; i < numSamples; ++i)
+				destination[i] += source[i];
+		}
+
+		static void MixWithGain(const float* source, float* destination, uint32 numSamples, float gain)
+		{
+			const uint32 numVectorized = GetVectorizedCount(numSamples);
+			const V gainVec = Vec::Set(gain);
+
+			uint32 i = 0;
+			for (; i < numVectorized; i += Width)
+				Vec::Store(destination + i, Vec::MulAdd(Vec::Load(source + i), gainVec, Vec::Load(destination + i)));
+
+			for (; i < numSamples; ++i)
+				destination[i] += source[i] * gain;
+		}
+
+		static void ApplyGain(float* samples, uint32 numSamples, float gain)
+		{
+			const uint32 numVectorized = GetVectorizedCount(numSamples);
+			const V gainVec = Vec::Set(gain);
+
+			uint32 i = 0;
+			for (; i < numVectorized; i += Width)
+				Vec::Store(samples + i, Vec::Mul(Vec::Load(samples + i), gainVec));
+
+			for (; i < numSamples; ++i)
+				samples[i] *= gain;
+		}
+
+		static void ApplyGainRamp(float* samples, uint32 numChannels, uint32 numFrames, float startGain, float endGain)
+		{
+			if (numFrames == 0)
+				return;
+
+			if (startGain == endGain)
+			{
+				ApplyGain(samples, numFrames * numChannels, startGain);
+				return;
+			}
+
+			const float step = (endGain - startGain) / static_cast<float>(numFrames);
+
+			uint32 frame = 0;
+
+			if (numChannels == 1)
+			{
+				// Gains of the first vector of frames, computed from the frame index
+				// rather than accumulated, to not drift over long blocks
+				alignas(64) float offsets[Width];
+				for (uint32 lane = 0; lane < Width; ++lane)
+					offsets[lane] = static_cast<float>(lane);
+
+				const V offsetsVec = Vec::Load(offsets);
+				const V stepVec = Vec::Set(step);
+
+				const uint32 numVectorized = GetVectorizedCount(numFrames);
+				for (; frame < numVectorized; frame += Width)
+				{
+					const V gain = Vec::MulAdd(offsetsVec, stepVec, Vec::Set(startGain + step * static_cast<float>(frame)));
+					Vec::Store(samples + frame, Vec::Mul(Vec::Load(samples + frame), gain));
+				}
+			}
+
+			for (; frame < numFrames; ++frame)
+			{
+				const float gain = startGain + step * static_cast<float>(frame);
+				for (uint32 channel = 0; channel < numChannels; ++channel)
+					samples[frame * numChannels + channel] *= gain;
+			}
+		}
+
+		static void Clamp(float* samples, uint32 numSamples, float minValue, float maxValue)
+		{
+			const uint32 numVectorized = GetVectorizedCount(numSamples);
+			const V minVec = Vec::Set(minValue);
+			const V maxVec = Vec::Set(maxValue);
+
+			uint32 i = 0;
+			for (; i < numVectorized; i += Width)
+				Vec::Store(samples + i, Vec::Min(Vec::Max(Vec::Load(samples + i), minVec), maxVec));
+
+			for (; i < numSamples; ++i)
+				samples[i] = MinScalar(MaxScalar(samples[i], minValue), maxValue);
+		}
+
+		static float FindPeak(const float* samples, uint32 numSamples)
+		{
+			const uint32 numVectorized = GetVectorizedCount(numSamples);
+
+			float peak = 0.0f;
+			uint32 i = 0;
+
+			if (numVectorized > 0)
+			{
+				V peakVec = Vec::Set(0.0f);
+				for (; i < numVectorized; i += Width)
+					peakVec = Vec::Max(peakVec, Vec::Abs(Vec::Load(samples + i)));
+
+				peak = Vec::ReduceMax(peakVec);
+			}
+
+			for (; i < numSamples; ++i)
+				peak = MaxScalar(peak, AbsScalar(samples[i]));
+
+			return peak;
+		}
+
+		static void Deinterleave(const float* interleaved, float* const* channels, uint32 numChannels, uint32 numFrames)
+		{
+			uint32 frame = 0;
+
+			if (numChannels == 2)
+			{
+				const uint32 numVectorized = GetVectorizedCount(numFrames);
+				for (; frame < numVectorized; frame += Width)
+					Vec::DeinterleaveStereo(interleaved + frame * 2, channels[0] + frame, channels[1] + frame);
+			}
+
+			for (; frame < numFrames; ++frame)
+				for (uint32 channel = 0; channel < numChannels; ++channel)
+					channels[channel][frame] = interleaved[frame * numChannels + channel];
+		}
+
+		static void Interleave(const float* const* channels, float* interleaved, uint32 numChannels, uint32 numFrames)
+		{
+			uint32 frame = 0;
+
+			if (numChannels == 2)
+			{
+				const uint32 numVectorized = GetVectorizedCount(numFrames);
+				for (; frame < numVectorized; frame += Width)
+					Vec::InterleaveStereo(channels[0] + frame, channels[1] + frame, interleaved + frame * 2);
+			}
+
+			for (; frame < numFrames; ++frame)
+				for (uint32 channel = 0; channel < numChannels; ++channel)
+					interleaved[frame * numChannels + channel] = channels[channel][frame];
+		}
+
+		static constexpr Kernels GetTable(const char* name)
+		{
+			return Kernels{
+				.Name = name,
+				.Mix = &Mix,
+				.MixWithGain = &MixWithGain,
+				.ApplyGain = &ApplyGain,
+				.ApplyGainRamp = &ApplyGainRamp,
+				.Clamp = &Clamp,
+				.FindPeak = &FindPeak,
+				.Deinterleave = &Deinterleave,
+				.Interleave = &Interleave
+			};
+		}
+	};
+} // namespace JPL::DSP::Internal
@@ -0,0 +1,93 @@
+﻿//
+//      ██╗██████╗     ██╗     ██╗██████╗ ███████╗
+//      ██║██╔══██╗    ██║     ██║██╔══██╗██╔════╝		** MiniaudioCpp **
+//      ██║██████╔╝    ██║     ██║██████╔╝███████╗
+// ██   ██║██╔═══╝     ██║     ██║██╔══██╗╚════██║		https://github.com/Jaytheway/MiniaudioCpp
+// ╚█████╔╝██║         ███████╗██║██████╔╝███████║
+//  ╚════╝ ╚═╝         ╚══════╝╚═╝╚═════╝ ╚══════╝
+//
+//   Copyright 2024 Jaroslav Pevno, MiniaudioCpp is offered under the terms of the ISC license:
+//
+//   Permission to use, copy, modify, and/or distribute this software for any purpose with or
+//   without fee is hereby granted, provided that the above copyright notice and this permission
+//   notice appear in all copies. THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+//   WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+//   AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+//   CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+//   WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+//   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#include "DSPKernels.h"
+
+// Compiled with AVX2 and FMA enabled for this file only, see CMakeLists.txt
+#if defined(JPL_USE_AVX2)
+#include <immintrin.h>
+
+namespace JPL::DSP::Internal
+{
+	namespace
+	{
+		struct VecAVX2
+		{
+			using Type = __m256;
+			static constexpr uint32 Width = 8;
+
+			static JPL_INLINE Type Load(const float* p) { return _mm256_loadu_ps(p); }
+			static JPL_INLINE void Store(float* p, Type v) { _mm256_storeu_ps(p, v); }
+			static JPL_INLINE Type Set(float value) { return _mm256_set1_ps(value); }
+			static JPL_INLINE Type Add(Type a, Type b) { return _mm256_add_ps(a, b); }
+			static JPL_INLINE Type Mul(Type a, Type b) { return _mm256_mul_ps(a, b); }
+#if defined(JPL_USE_FMADD)
+			static JPL_INLINE Type MulAdd(Type a, Type b, Type c) { return _mm256_fmadd_ps(a, b, c); }
+#else
+			static JPL_INLINE Type MulAdd(Type a, Type b, Type c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+#endif
+			static JPL_INLINE Type Min(Type a, Type b) { return _mm256_min_ps(a, b); }
+			static JPL_INLINE Type Max(Type a, Type b) { return _mm256_max_ps(a, b); }
+			static JPL_INLINE Type Abs(Type v) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v); }
+
+			static JPL_INLINE float ReduceMax(Type v)
+			{
+				__m128 m = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+				m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+				m = _mm_max_ss(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 1, 1, 1)));
+				return _mm_cvtss_f32(m);
+			}
+
+			static JPL_INLINE void DeinterleaveStereo(const float* frames, float* left, float* right)
+			{
+				const __m256 a = _mm256_loadu_ps(frames);		// L0 R0 L1 R1 | L2 R2 L3 R3
+				const __m256 b = _mm256_loadu_ps(frames + 8);	// L4 R4 L5 R5 | L6 R6 L7 R7
+
+				// Shuffles work within 128-bit lanes: L0 L1 L4 L5 | L2 L3 L6 L7, put the middle quarters in order
+				const __m256 l = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+				const __m256 r = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+				_mm256_storeu_ps(left, _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(l), _MM_SHUFFLE(3, 1, 2, 0))));
+				_mm256_storeu_ps(right, _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(r), _MM_SHUFFLE(3, 1, 2, 0))));
+			}
+
+			static JPL_INLINE void InterleaveStereo(const float* left, const float* right, float* frames)
+			{
+				const __m256 l = _mm256_loadu_ps(left);
+				const __m256 r = _mm256_loadu_ps(right);
+				const __m256 low = _mm256_unpacklo_ps(l, r);	// L0 R0 L1 R1 | L4 R4 L5 R5
+				const __m256 high = _mm256_unpackhi_ps(l, r);	// L2 R2 L3 R3 | L6 R6 L7 R7
+				_mm256_storeu_ps(frames, _mm256_permute2f128_ps(low, high, 0x20));
+				_mm256_storeu_ps(frames + 8, _mm256_permute2f128_ps(low, high, 0x31));
+			}
+		};
+
+		constexpr Kernels sKernels = TKernels<VecAVX2>::GetTable("AVX2");
+	}
+
+	const Kernels* GetKernelsAVX2() { return &sKernels; }
+} // namespace JPL::DSP::Internal
+
+#else
+
+namespace JPL::DSP::Internal
+{
+	const Kernels* GetKernelsAVX2() { return nullptr; }
+}
+
+#endif
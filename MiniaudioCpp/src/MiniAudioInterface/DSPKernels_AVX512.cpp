@@ -0,0 +1,84 @@
+﻿//
+//      ██╗██████╗     ██╗     ██╗██████╗ ███████╗
+//      ██║██╔══██╗    ██║     ██║██╔══██╗██╔════╝		** MiniaudioCpp **
+//      ██║██████╔╝    ██║     ██║██████╔╝███████╗
+// ██   ██║██╔═══╝     ██║     ██║██╔══██╗╚════██║		https://github.com/Jaytheway/MiniaudioCpp
+// ╚█████╔╝██║         ███████╗██║██████╔╝███████║
+//  ╚════╝ ╚═╝         ╚══════╝╚═╝╚═════╝ ╚══════╝
+//
+//   Copyright 2024 Jaroslav Pevno, MiniaudioCpp is offered under the terms of the ISC license:
+//
+//   Permission to use, copy, modify, and/or distribute this software for any purpose with or
+//   without fee is hereby granted, provided that the above copyright notice and this permission
+//   notice appear in all copies. THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+//   WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+//   AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+//   CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+//   WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+//   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#include "DSPKernels.h"
+
+// Compiled with AVX-512 enabled for this file only, see CMakeLists.txt
+#if defined(JPL_USE_AVX512)
+#include <immintrin.h>
+
+namespace JPL::DSP::Internal
+{
+	namespace
+	{
+		struct VecAVX512
+		{
+			using Type = __m512;
+			static constexpr uint32 Width = 16;
+
+			static JPL_INLINE Type Load(const float* p) { return _mm512_loadu_ps(p); }
+			static JPL_INLINE void Store(float* p, Type v) { _mm512_storeu_ps(p, v); }
+			static JPL_INLINE Type Set(float value) { return _mm512_set1_ps(value); }
+			static JPL_INLINE Type Add(Type a, Type b) { return _mm512_add_ps(a, b); }
+			static JPL_INLINE Type Mul(Type a, Type b) { return _mm512_mul_ps(a, b); }
+			static JPL_INLINE Type MulAdd(Type a, Type b, Type c) { return _mm512_fmadd_ps(a, b, c); }
+			static JPL_INLINE Type Min(Type a, Type b) { return _mm512_min_ps(a, b); }
+			static JPL_INLINE Type Max(Type a, Type b) { return _mm512_max_ps(a, b); }
+			static JPL_INLINE Type Abs(Type v) { return _mm512_abs_ps(v); }
+			static JPL_INLINE float ReduceMax(Type v) { return _mm512_reduce_max_ps(v); }
+
+			static JPL_INLINE void DeinterleaveStereo(const float* frames, float* left, float* right)
+			{
+				const __m512 a = _mm512_loadu_ps(frames);
+				const __m512 b = _mm512_loadu_ps(frames + 16);
+
+				// Even and odd elements of the concatenation of 'a' and 'b'
+				const __m512i even = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+				const __m512i odd = _mm512_setr_epi32(1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31);
+				_mm512_storeu_ps(left, _mm512_permutex2var_ps(a, even, b));
+				_mm512_storeu_ps(right, _mm512_permutex2var_ps(a, odd, b));
+			}
+
+			static JPL_INLINE void InterleaveStereo(const float* left, const float* right, float* frames)
+			{
+				const __m512 l = _mm512_loadu_ps(left);
+				const __m512 r = _mm512_loadu_ps(right);
+
+				// Indices 0-15 select from 'l', 16-31 from 'r'
+				const __m512i low = _mm512_setr_epi32(0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23);
+				const __m512i high = _mm512_setr_epi32(8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31);
+				_mm512_storeu_ps(frames, _mm512_permutex2var_ps(l, low, r));
+				_mm512_storeu_ps(frames + 16, _mm512_permutex2var_ps(l, high, r));
+			}
+		};
+
+		constexpr Kernels sKernels = TKernels<VecAVX512>::GetTable("AVX-512");
+	}
+
+	const Kernels* GetKernelsAVX512() { return &sKernels; }
+} // namespace JPL::DSP::Internal
+
+#else
+
+namespace JPL::DSP::Internal
+{
+	const Kernels* GetKernelsAVX512() { return nullptr; }
+}
+
+#endif
@@ -0,0 +1,72 @@
+﻿//
+//      ██╗██████╗     ██╗     ██╗██████╗ ███████╗
+//      ██║██╔══██╗    ██║     ██║██╔══██╗██╔════╝		** MiniaudioCpp **
+//      ██║██████╔╝    ██║     ██║██████╔╝███████╗
+// ██   ██║██╔═══╝     ██║     ██║██╔══██╗╚════██║		https://github.com/Jaytheway/MiniaudioCpp
+// ╚█████╔╝██║         ███████╗██║██████╔╝███████║
+//  ╚════╝ ╚═╝         ╚══════╝╚═╝╚═════╝ ╚══════╝
+//
+//   Copyright 2024 Jaroslav Pevno, MiniaudioCpp is offered under the terms of the ISC license:
+//
+//   Permission to use, copy, modify, and/or distribute this software for any purpose with or
+//   without fee is hereby granted, provided that the above copyright notice and this permission
+//   notice appear in all copies. THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+//   WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+//   AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+//   CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+//   WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+//   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#include "DSPKernels.h"
+
+#if defined(JPL_USE_NEON)
+#include <arm_neon.h>
+
+namespace JPL::DSP::Internal
+{
+	namespace
+	{
+		struct VecNEON
+		{
+			using Type = float32x4_t;
+			static constexpr uint32 Width = 4;
+
+			static JPL_INLINE Type Load(const float* p) { return vld1q_f32(p); }
+			static JPL_INLINE void Store(float* p, Type v) { vst1q_f32(p, v); }
+			static JPL_INLINE Type Set(float value) { return vdupq_n_f32(value); }
+			static JPL_INLINE Type Add(Type a, Type b) { return vaddq_f32(a, b); }
+			static JPL_INLINE Type Mul(Type a, Type b) { return vmulq_f32(a, b); }
+			static JPL_INLINE Type MulAdd(Type a, Type b, Type c) { return vfmaq_f32(c, a, b); }
+			static JPL_INLINE Type Min(Type a, Type b) { return vminq_f32(a, b); }
+			static JPL_INLINE Type Max(Type a, Type b) { return vmaxq_f32(a, b); }
+			static JPL_INLINE Type Abs(Type v) { return vabsq_f32(v); }
+			static JPL_INLINE float ReduceMax(Type v) { return vmaxvq_f32(v); }
+
+			static JPL_INLINE void DeinterleaveStereo(const float* frames, float* left, float* right)
+			{
+				const float32x4x2_t lr = vld2q_f32(frames);
+				vst1q_f32(left, lr.val[0]);
+				vst1q_f32(right, lr.val[1]);
+			}
+
+			static JPL_INLINE void InterleaveStereo(const float* left, const float* right, float* frames)
+			{
+				const float32x4x2_t lr{ vld1q_f32(left), vld1q_f32(right) };
+				vst2q_f32(frames, lr);
+			}
+		};
+
+		constexpr Kernels sKernels = TKernels<VecNEON>::GetTable("NEON");
+	}
+
+	const Kernels* GetKernelsNEON() { return &sKernels; }
+} // namespace JPL::DSP::Internal
+
+#else
+
+namespace JPL::DSP::Internal
+{
+	const Kernels* GetKernelsNEON() { return nullptr; }
+}
+
+#endif
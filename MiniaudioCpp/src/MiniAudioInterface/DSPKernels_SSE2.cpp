@@ -0,0 +1,81 @@
+﻿//
+//      ██╗██████╗     ██╗     ██╗██████╗ ███████╗
+//      ██║██╔══██╗    ██║     ██║██╔══██╗██╔════╝		** MiniaudioCpp **
+//      ██║██████╔╝    ██║     ██║██████╔╝███████╗
+// ██   ██║██╔═══╝     ██║     ██║██╔══██╗╚════██║		https://github.com/Jaytheway/MiniaudioCpp
+// ╚█████╔╝██║         ███████╗██║██████╔╝███████║
+//  ╚════╝ ╚═╝         ╚══════╝╚═╝╚═════╝ ╚══════╝
+//
+//   Copyright 2024 Jaroslav Pevno, MiniaudioCpp is offered under the terms of the ISC license:
+//
+//   Permission to use, copy, modify, and/or distribute this software for any purpose with or
+//   without fee is hereby granted, provided that the above copyright notice and this permission
+//   notice appear in all copies. THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+//   WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+//   AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+//   CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+//   WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+//   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#include "DSPKernels.h"
+
+#if defined(JPL_USE_SSE)
+#include <immintrin.h>
+
+namespace JPL::DSP::Internal
+{
+	namespace
+	{
+		struct VecSSE2
+		{
+			using Type = __m128;
+			static constexpr uint32 Width = 4;
+
+			static JPL_INLINE Type Load(const float* p) { return _mm_loadu_ps(p); }
+			static JPL_INLINE void Store(float* p, Type v) { _mm_storeu_ps(p, v); }
+			static JPL_INLINE Type Set(float value) { return _mm_set1_ps(value); }
+			static JPL_INLINE Type Add(Type a, Type b) { return _mm_add_ps(a, b); }
+			static JPL_INLINE Type Mul(Type a, Type b) { return _mm_mul_ps(a, b); }
+			static JPL_INLINE Type MulAdd(Type a, Type b, Type c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+			static JPL_INLINE Type Min(Type a, Type b) { return _mm_min_ps(a, b); }
+			static JPL_INLINE Type Max(Type a, Type b) { return _mm_max_ps(a, b); }
+			static JPL_INLINE Type Abs(Type v) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), v); }
+
+			static JPL_INLINE float ReduceMax(Type v)
+			{
+				__m128 m = _mm_max_ps(v, _mm_movehl_ps(v, v));
+				m = _mm_max_ss(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 1, 1, 1)));
+				return _mm_cvtss_f32(m);
+			}
+
+			static JPL_INLINE void DeinterleaveStereo(const float* frames, float* left, float* right)
+			{
+				const __m128 a = _mm_loadu_ps(frames);		// L0 R0 L1 R1
+				const __m128 b = _mm_loadu_ps(frames + 4);	// L2 R2 L3 R3
+				_mm_storeu_ps(left, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+				_mm_storeu_ps(right, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+			}
+
+			static JPL_INLINE void InterleaveStereo(const float* left, const float* right, float* frames)
+			{
+				const __m128 l = _mm_loadu_ps(left);
+				const __m128 r = _mm_loadu_ps(right);
+				_mm_storeu_ps(frames, _mm_unpacklo_ps(l, r));		// L0 R0 L1 R1
+				_mm_storeu_ps(frames + 4, _mm_unpackhi_ps(l, r));	// L2 R2 L3 R3
+			}
+		};
+
+		constexpr Kernels sKernels = TKernels<VecSSE2>::GetTable("SSE2");
+	}
+
+	const Kernels* GetKernelsSSE2() { return &sKernels; }
+} // namespace JPL::DSP::Internal
+
+#else
+
+namespace JPL::DSP::Internal
+{
+	const Kernels* GetKernelsSSE2() { return nullptr; }
+}
+
+#endif
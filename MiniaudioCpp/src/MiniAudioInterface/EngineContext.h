@@ -0,0 +1,50 @@
+﻿//
+//      ██╗██████╗     ██╗     ██╗██████╗ ███████╗
+//      ██║██╔══██╗    ██║     ██║██╔══██╗██╔════╝		** MiniaudioCpp **
+//      ██║██████╔╝    ██║     ██║██████╔╝███████╗
+// ██   ██║██╔═══╝     ██║     ██║██╔══██╗╚════██║		https://github.com/Jaytheway/MiniaudioCpp
+// ╚█████╔╝██║         ███████╗██║██████╔╝███████║
+//  ╚════╝ ╚═╝         ╚══════╝╚═╝╚═════╝ ╚══════╝
+//
+//   Copyright 2024 Jaroslav Pevno, MiniaudioCpp is offered under the terms of the ISC license:
+//
+//   Permission to use, copy, modify, and/or distribute this software for any purpose with or
+//   without fee is hereby granted, provided that the above copyright notice and this permission
+//   notice appear in all copies. THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+//   WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+//   AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+//   CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+//   WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+//   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#pragma once
+
+#include "MiniaudioWrappers.h"
+#include "CallbackProfiler.h"
+#include "CommandQueue.h"
+
+#include <memory>
+
+namespace JPL::Internal
+{
+	//==========================================================================
+	/// Per-engine state of the audio callback.
+	/// Owned by the Engine wrapper and passed to miniaudio as ma_engine::pProcessUserData,
+	/// so that it can be reached from the device data callback.
+	struct EngineContext
+	{
+		std::unique_ptr<CallbackProfiler> Profiler;
+		std::unique_ptr<CommandQueue> Commands;
+		bool bFlushDenormals = true;
+
+		// Processing entry point of the engine, for both the device and offline rendering
+		ma_uint64 Process(ma_engine* engine, float* output, ma_uint64 numFrames);
+
+		static void DeviceDataCallback(ma_device* device, void* output, const void* input, ma_uint32 numFrames);
+
+		static JPL_INLINE EngineContext* Get(ma_engine* engine)
+		{
+			return static_cast<EngineContext*>(engine->pProcessUserData);
+		}
+	};
+} // namespace JPL::Internal
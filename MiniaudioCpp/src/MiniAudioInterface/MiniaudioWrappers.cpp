@@ -18,17 +18,26 @@
 //   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 
 #include "MiniaudioWrappers.h"
+#include "EngineContext.h"
 
 #include "VFS.h"
 
 #include "ErrorReporting.h"
+#include "RealtimeLog.h"
 
 // We have to import this stuff because miniaudio
 // doesn't expose some of the functionality we need
 #include "c89atomic.h"
 
+#include <atomic>
 #include <string>
 #include <format>
+#include <limits>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
 
 
 namespace JPL
@@ -59,14 +68,11 @@ namespace JPL
 
 	namespace // log
 	{
-		void MALogCallback(void* pUserData, ma_uint32 level, const char* pMessage)
+		void PrintLogRecord(const RealtimeLog::Record& record)
 		{
-			std::string message = std::format("{0}: {1}", std::string(ma_log_level_to_string(level)), pMessage);
-			message.erase(std::remove(message.begin(), message.end(), '\n'), message.end());
-			message.erase(std::remove(message.begin(), message.end(), '{'), message.end());
-			message.erase(std::remove(message.begin(), message.end(), '}'), message.end());
+			const std::string message = std::format("{0}: {1}", ma_log_level_to_string(record.Level), record.GetMessage());
 
-			switch (level)
+			switch (record.Level)
 			{
 				case MA_LOG_LEVEL_INFO:
 					JPL_TRACE_TAG("miniaudio", message);
@@ -82,46 +88,188 @@ namespace JPL
 			}
 		}
 
+		// Never destroyed, miniaudio may still log while static engines are destroyed at exit
+		RealtimeLog& GetMiniaudioLogRing()
+		{
+			static RealtimeLog* sRing = new RealtimeLog();
+			return *sRing;
+		}
+
+		//======================================================================
+		/// miniaudio may log from the audio thread, so the log callback only copies
+		/// the message into a preallocated ring, and this thread formats and prints it.
+		class MiniaudioLogThread
+		{
+		public:
+			MiniaudioLogThread()
+				: mThread([this](std::stop_token stopToken) { Run(stopToken); })
+			{
+			}
+
+			~MiniaudioLogThread()
+			{
+				mThread.request_stop();
+				mThread.join();
+
+				// Print whatever was pushed while stopping
+				GetMiniaudioLogRing().Drain(PrintLogRecord);
+			}
+
+		private:
+			void Run(std::stop_token stopToken)
+			{
+				// Polling instead of notifying from the producers, which may be a system call on the audio thread
+				static constexpr auto cPollInterval = std::chrono::milliseconds(20);
+
+				std::mutex waitMutex;
+				std::condition_variable_any waitCondition;
+				while (!stopToken.stop_requested())
+				{
+					{
+						std::unique_lock lock(waitMutex);
+						waitCondition.wait_for(lock, stopToken, cPollInterval, [] { return false; });
+					}
+					GetMiniaudioLogRing().Drain(PrintLogRecord);
+				}
+			}
+
+		private:
+			std::jthread mThread;
+		};
+
+		void MALogCallback(void* /*pUserData*/, ma_uint32 level, const char* pMessage)
+		{
+			GetMiniaudioLogRing().Push(level, pMessage);
+		}
+
 		ma_log g_maLog;
+
+		// All engines share the same logger, so it's initialized only once
+		ma_log* GetMiniaudioLog()
+		{
+			static std::once_flag sLogInitFlag;
+			std::call_once(sLogInitFlag, []
+			{
+				// Allocate the ring before anything can log from the audio thread
+				GetMiniaudioLogRing();
+
+				// Stopped and flushed at exit
+				static MiniaudioLogThread sLogThread;
+
+				ma_result result = ma_log_init(gEngineAllocationCallbacks, &g_maLog);
+				JPL_ASSERT(result == MA_SUCCESS, "Failed to initialize miniaudio logger.");
+
+				ma_log_callback logCallback = ma_log_callback_init(&MALogCallback, nullptr);
+				result = ma_log_register_callback(&g_maLog, logCallback);
+				JPL_ASSERT(result == MA_SUCCESS, "Failed to register miniaudio log callback.");
+			});
+
+			return &g_maLog;
+		}
 	}
 
 	//==========================================================================
-	bool Engine::Init(uint32_t numChannels, ma_vfs* vfs)
+	ma_uint64 Internal::EngineContext::Process(ma_engine* engine, float* output, ma_uint64 numFrames)
+	{
+		ScopedFlushDenormals flushDenormals(bFlushDenormals);
+
+		if (Profiler)
+			Profiler->BeginCallback();
+
+		// Apply parameter changes submitted since the last block
+		if (Commands)
+			Commands->ConsumeAll([](const ParameterCommand& command) { command.Apply(); });
+
+		ma_uint64 framesRead = 0;
+		ma_engine_read_pcm_frames(engine, output, numFrames, &framesRead);
+
+		if (Profiler)
+			Profiler->EndCallback(static_cast<uint32>(numFrames), ma_engine_get_sample_rate(engine));
+
+		return framesRead;
+	}
+
+	void Internal::EngineContext::DeviceDataCallback(ma_device* device, void* output, const void* /*input*/, ma_uint32 numFrames)
+	{
+		// miniaudio sets the engine as the device user data
+		ma_engine* engine = static_cast<ma_engine*>(device->pUserData);
+		Get(engine)->Process(engine, static_cast<float*>(output), numFrames);
+	}
+
+	//==========================================================================
+	Engine::Engine() = default;
+
+	Engine::~Engine()
+	{
+		// Stop the device before destroying the state used by the audio callback
+		reset();
+	}
+
+	Engine::Engine(Engine&&) noexcept = default;
+	Engine& Engine::operator=(Engine&&) noexcept = default;
+
+	bool Engine::Init(const EngineSettings& settings)
 	{
 		ma_result result = MA_SUCCESS;
 
+		// Previous engine may still be using the old context until it's uninitialized by emplace
+		auto context = std::make_unique<Internal::EngineContext>();
+		if (settings.EnableProfiling)
+			context->Profiler = std::make_unique<CallbackProfiler>();
+		if (settings.CommandQueueCapacity > 0)
+			context->Commands = std::make_unique<CommandQueue>(settings.CommandQueueCapacity);
+		context->bFlushDenormals = settings.FlushDenormals;
+
 		ma_engine_config engineConfig = ma_engine_config_init();
-		engineConfig.allocationCallbacks = GetDefaultMAAllocationCallbacks();
+		if (settings.AllocationCallbacks)
+			engineConfig.allocationCallbacks = *settings.AllocationCallbacks;
+		else if (gEngineAllocationCallbacks)
+			engineConfig.allocationCallbacks = *gEngineAllocationCallbacks;
+		else
+			engineConfig.allocationCallbacks = GetDefaultMAAllocationCallbacks();
 
 		// Channel count is only honored if using custom device or MA_NO_DEVICE_IO
-		engineConfig.channels = numChannels;
+		engineConfig.channels = settings.NumChannels;
+		engineConfig.sampleRate = settings.SampleRate;
 
-		// TODO: for now splitter node and custom node don't work toghether if custom periodSizeInFrames is set
-		//engineConfig.periodSizeInFrames = PCM_FRAME_CHUNK_SIZE;
+		// This also sets the processing size of the node graph and the capacity of the node caches.
+		// Custom nodes handle input frame count not matching the output, see TBaseNode::sProcess
+		engineConfig.periodSizeInFrames = settings.PeriodSizeInFrames;
 
-		// Hook up logging
+		engineConfig.pLog = GetMiniaudioLog();
+		engineConfig.noDevice = settings.Offline;
+		engineConfig.pResourceManagerVFS = settings.VFS;
+		engineConfig.pResourceManager = settings.ResourceManager;
+
+		engineConfig.dataCallback = &Internal::EngineContext::DeviceDataCallback;
+		engineConfig.pProcessUserData = context.get();
+
+		if (settings.Offline)
 		{
-			result = ma_log_init(gEngineAllocationCallbacks, &g_maLog);
-			JPL_ASSERT(result == MA_SUCCESS, "Failed to initialize miniaudio logger.");
-			
-			ma_log_callback logCallback = ma_log_callback_init(&MALogCallback, nullptr);
-			result = ma_log_register_callback(&g_maLog, logCallback);
-			JPL_ASSERT(result == MA_SUCCESS, "Failed to register miniaudio log callback.");
-		}
+			// Without a device there is nothing to pick the format from
+			if (engineConfig.channels == 0)
+				engineConfig.channels = MA_DEFAULT_CHANNELS;
 
-		engineConfig.pLog = &g_maLog;
-		engineConfig.noDevice = false;
-		engineConfig.pResourceManagerVFS = vfs;
+			if (engineConfig.sampleRate == 0)
+				engineConfig.sampleRate = MA_DEFAULT_SAMPLE_RATE;
+		}
 
 		result = emplace(&engineConfig);
 		
 		if (!JPL_ENSURE(!result))
 		{
-			ma_engine* node = release();
-			delete node;
+			discard();
+			mContext.reset();
+			return false;
 		}
 
-		return result == MA_SUCCESS;
+		mContext = std::move(context);
+		return true;
+	}
+
+	bool Engine::Init(uint32_t numChannels, ma_vfs* vfs)
+	{
+		return Init(EngineSettings{ .NumChannels = numChannels, .VFS = vfs });
 	}
 
 	uint32_t Engine::GetSampleRate() const
@@ -129,6 +277,21 @@ namespace JPL
 		return ma_engine_get_sample_rate(get());
 	}
 
+	uint64_t Engine::GetTimeInFrames() const
+	{
+		return ma_engine_get_time_in_pcm_frames(get());
+	}
+
+	uint64_t Engine::GetTimeInMilliseconds() const
+	{
+		return ma_engine_get_time_in_milliseconds(get());
+	}
+
+	uint32_t Engine::GetNumChannels() const
+	{
+		return ma_engine_get_channels(get());
+	}
+
 	uint32_t Engine::GetProcessingSizeInFrames() const
 	{
 		if (auto* node = get())
@@ -145,6 +308,83 @@ namespace JPL
 		return InputBusIndex(0).Of(&get()->nodeGraph.endpoint);
 	}
 
+	bool Engine::IsOffline() const
+	{
+		const ma_engine* engine = get();
+		return engine && engine->pDevice == nullptr;
+	}
+
+	uint64_t Engine::Render(std::span<float> output, uint64_t numFrames)
+	{
+		if (!JPL_ENSURE(IsOffline(), "Render can only be called on an engine initialized in offline mode."))
+			return 0;
+
+		const uint32_t numChannels = GetNumChannels();
+		numFrames = std::min(numFrames, static_cast<uint64_t>(output.size() / numChannels));
+
+		return static_cast<uint64_t>(mContext->Process(get(), output.data(), numFrames));
+	}
+
+	bool Engine::RenderToFile(const char* filePath, uint64_t numFrames)
+	{
+		if (!filePath || !JPL_ENSURE(IsOffline(), "RenderToFile can only be called on an engine initialized in offline mode."))
+			return false;
+
+		const uint32_t numChannels = GetNumChannels();
+
+		const ma_encoder_config config = ma_encoder_config_init(ma_encoding_format_wav, ma_format_f32, numChannels, GetSampleRate());
+		ma_encoder encoder;
+		if (ma_encoder_init_file(filePath, &config, &encoder) != MA_SUCCESS)
+			return false;
+
+		const uint64_t blockSize = GetProcessingSizeInFrames();
+		std::vector<float> buffer(blockSize * numChannels);
+
+		bool success = true;
+		for (uint64_t framesLeft = numFrames; framesLeft > 0 && success;)
+		{
+			const uint64_t framesRendered = Render(buffer, std::min(framesLeft, blockSize));
+
+			// Nothing rendered, e.g. the engine failed to read the node graph
+			if (framesRendered == 0)
+			{
+				success = false;
+				break;
+			}
+
+			ma_uint64 framesWritten = 0;
+			success = ma_encoder_write_pcm_frames(&encoder, buffer.data(), framesRendered, &framesWritten) == MA_SUCCESS
+				&& framesWritten == framesRendered;
+
+			framesLeft -= framesRendered;
+		}
+
+		ma_encoder_uninit(&encoder);
+		return success;
+	}
+
+	bool Engine::Submit(CommandBatch& batch)
+	{
+		if (!mContext || !mContext->Commands)
+			return false;
+
+		if (!mContext->Commands->Push(batch.GetCommands()))
+			return false;
+
+		batch.Clear();
+		return true;
+	}
+
+	const CallbackProfiler* Engine::GetProfiler() const
+	{
+		return mContext ? mContext->Profiler.get() : nullptr;
+	}
+
+	CallbackProfiler* Engine::GetProfiler()
+	{
+		return mContext ? mContext->Profiler.get() : nullptr;
+	}
+
 	//==========================================================================
 	ma_node_config BaseNode::InitConfig(const NodeLayout& nodeLayout, bool initStarted)
 	{
@@ -161,11 +401,16 @@ namespace JPL
 
 	//==========================================================================
 	bool SplitterNode::Init(uint32_t numChannels, uint32_t numOutputBusses /*= 2*/)
+	{
+		return Init(GetMiniaudioEngine(nullptr), numChannels, numOutputBusses);
+	}
+
+	bool SplitterNode::Init(Engine& engine, uint32_t numChannels, uint32_t numOutputBusses /*= 2*/)
 	{
 		if (numChannels == 0 || numOutputBusses == 0)
 			return false;
 
-		if (Engine& engine = GetMiniaudioEngine(nullptr))
+		if (engine)
 		{
 			ma_splitter_node_config splitterConfig = ma_splitter_node_config_init(numChannels);
 			splitterConfig.outputBusCount = std::max(1u, numOutputBusses);
@@ -174,8 +419,7 @@ namespace JPL
 			
 			if (!JPL_ENSURE(!result))
 			{
-				ma_splitter_node* node = release();
-				delete node;
+				discard();
 				return false;
 			}
 
@@ -189,11 +433,16 @@ namespace JPL
 
 	//==========================================================================
 	bool EngineNode::InitGroup(const GroupNodeSettings& settings)
+	{
+		return InitGroup(GetMiniaudioEngine(nullptr), settings);
+	}
+
+	bool EngineNode::InitGroup(Engine& engine, const GroupNodeSettings& settings)
 	{
 		if (settings.NumInChannels == 0 || settings.NumOutChannels == 0)
 			return false;
 
-		if (Engine& engine = GetMiniaudioEngine(nullptr))
+		if (engine)
 		{
 			ma_engine_node_config nodeConfig = ma_engine_node_config_init(engine, ma_engine_node_type_group, MA_SOUND_FLAG_NO_SPATIALIZATION);
 
@@ -206,8 +455,7 @@ namespace JPL
 
 			if (!JPL_ENSURE(!result))
 			{
-				ma_engine_node* node = release();
-				delete node;
+				discard();
 				return false;
 			}
 
@@ -249,9 +497,134 @@ namespace JPL
 	}
 
 	//==========================================================================
+	namespace Internal
+	{
+		struct AsyncLoadState
+		{
+			// Must be the first member, miniaudio passes its address to onSignal
+			ma_async_notification_callbacks Notification{ .onSignal = OnSignal };
+
+			ma_fence Fence;
+
+			// Owned by the load rather than the sound, so that the job thread never touches the sound.
+			// The sound reads from it, and must be uninitialized first, see Sound::Reset.
+			ma_resource_manager_data_source DataSource{};
+
+			std::atomic<ma_result> Result{ MA_BUSY };
+			SoundLoad::Callback OnLoaded;
+			bool bPending = false;					// Fence has been acquired by the load
+			bool bDataSourceInitialized = false;
+
+			AsyncLoadState() { ma_fence_init(&Fence); }
+			~AsyncLoadState()
+			{
+				// Job thread may still be using the fence and the data source
+				if (bPending)
+					ma_fence_wait(&Fence);
+				if (bDataSourceInitialized)
+					ma_resource_manager_data_source_uninit(&DataSource);
+				ma_fence_uninit(&Fence);
+			}
+
+			AsyncLoadState(const AsyncLoadState&) = delete;
+			AsyncLoadState& operator=(const AsyncLoadState&) = delete;
+
+			// Called on a job thread before the fence is released
+			static void OnSignal(ma_async_notification* notification)
+			{
+				auto* state = static_cast<AsyncLoadState*>(notification);
+
+				const ma_result result = ma_resource_manager_data_source_result(&state->DataSource);
+				state->Result.store(result, std::memory_order_release);
+
+				if (state->OnLoaded)
+					state->OnLoaded(result == MA_SUCCESS);
+			}
+		};
+	} // namespace Internal
+
+	bool SoundLoad::IsDone() const
+	{
+		return mState && mState->Result.load(std::memory_order_acquire) != MA_BUSY;
+	}
+
+	bool SoundLoad::Wait() const
+	{
+		if (!mState)
+			return false;
+
+		ma_fence_wait(&mState->Fence);
+		return mState->Result.load(std::memory_order_acquire) == MA_SUCCESS;
+	}
+
+	bool SoundLoad::WaitAll(std::span<const SoundLoad> loads)
+	{
+		bool bAllSucceeded = true;
+		for (const SoundLoad& load : loads)
+		{
+			if (load.IsValid())
+				bAllSucceeded &= load.Wait();
+		}
+		return bAllSucceeded;
+	}
+
+	//==========================================================================
+	Sound::~Sound()
+	{
+		Reset();
+	}
+
+	Sound::Sound(Sound&& other) noexcept
+		: Traits::NodeDefaultTraits<Internal::Sound>(std::move(other))
+		, mVirtual(std::exchange(other.mVirtual, std::nullopt))
+		, mLoadState(std::move(other.mLoadState))
+	{
+	}
+
+	Sound& Sound::operator=(Sound&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Reset();
+			Traits::NodeDefaultTraits<Internal::Sound>::operator=(std::move(other));
+			mVirtual = std::exchange(other.mVirtual, std::nullopt);
+			mLoadState = std::move(other.mLoadState);
+		}
+		return *this;
+	}
+
+	void Sound::clear()
+	{
+		Reset();
+	}
+
+	void Sound::WaitForLoad()
+	{
+		// Also when the load is referenced by SoundLoad handles, the job thread must be done with the sound
+		if (mLoadState && mLoadState->bPending)
+			ma_fence_wait(&mLoadState->Fence);
+	}
+
+	void Sound::Reset()
+	{
+		WaitForLoad();
+
+		// Sound reads from the data source of the load, it must go first
+		Traits::NodeDefaultTraits<Internal::Sound>::clear();
+		mVirtual.reset();
+		mLoadState.reset();
+	}
+
 	bool Sound::Init(const char* filePathOrId, uint32_t flags, bool bUseSourceChannelCount)
 	{
-		if (Engine& engine = GetMiniaudioEngine(nullptr))
+		return Init(GetMiniaudioEngine(nullptr), filePathOrId, flags, bUseSourceChannelCount);
+	}
+
+	bool Sound::Init(Engine& engine, const char* filePathOrId, uint32_t flags, bool bUseSourceChannelCount)
+	{
+		Reset();
+
+		if (engine)
 		{
 			// Force disable miniaudio's spatialization, we use our own spatializer
 			flags |= MA_SOUND_FLAG_NO_SPATIALIZATION;
@@ -263,7 +636,7 @@ namespace JPL
 				// the sound if the channel count requested doesn't match the default attachment.
 				flags |= MA_SOUND_FLAG_NO_DEFAULT_ATTACHMENT;
 
-				reset(new ma_sound());
+				allocate();
 
 				ma_sound_config config;
 				config = ma_sound_config_init_2(engine.get());
@@ -282,8 +655,7 @@ namespace JPL
 
 			if (!JPL_ENSURE(!result))
 			{
-				ma_sound* node = release();
-				delete node;
+				discard();
 				return false;
 			}
 
@@ -297,21 +669,35 @@ namespace JPL
 
 	bool Sound::InitFromDataSource(Internal::DataSource& dataSource, uint32_t flags)
 	{
+		return InitFromDataSource(GetMiniaudioEngine(nullptr), dataSource, flags);
+	}
+
+	bool Sound::InitFromDataSource(Engine& engine, Internal::DataSource& dataSource, uint32_t flags)
+	{
+		if (!dataSource)
+			return false;
+
+		return InitFromDataSource(engine, static_cast<ma_data_source*>(dataSource.get()), flags);
+	}
+
+	bool Sound::InitFromDataSource(Engine& engine, ma_data_source* dataSource, uint32_t flags)
+	{
+		Reset();
+
 		if (!dataSource)
 			return false;
 
-		if (Engine& engine = GetMiniaudioEngine(nullptr))
+		if (engine)
 		{
 			// Force disable miniaudio's spatialization, we use our own spatializer
 			flags |= MA_SOUND_FLAG_NO_SPATIALIZATION;
 
-			reset(new ma_sound());
+			allocate();
 
-			ma_result result = ma_sound_init_from_data_source(engine, dataSource.get(), flags, static_cast<ma_sound_group*>(nullptr), get());
+			ma_result result = ma_sound_init_from_data_source(engine, dataSource, flags, static_cast<ma_sound_group*>(nullptr), get());
 			if (!JPL_ENSURE(!result))
 			{
-				ma_sound* node = release();
-				delete node;
+				discard();
 				return false;
 			}
 
@@ -323,6 +709,98 @@ namespace JPL
 		}
 	}
 
+	bool Sound::InitCopy(const Sound& source, uint32_t flags)
+	{
+		Reset();
+
+		if (!source)
+			return false;
+
+		// Force disable miniaudio's spatialization, we use our own spatializer
+		flags |= MA_SOUND_FLAG_NO_SPATIALIZATION;
+
+		ma_engine* engine = ma_sound_get_engine(source.get());
+
+		allocate();
+
+		ma_result result = ma_sound_init_copy(engine, source.get(), flags, static_cast<ma_sound_group*>(nullptr), get());
+		if (!JPL_ENSURE(!result))
+		{
+			discard();
+			return false;
+		}
+
+		return result == MA_SUCCESS;
+	}
+
+	SoundLoad Sound::InitAsync(const char* filePathOrId, uint32_t flags, SoundLoad::Callback onLoaded)
+	{
+		return InitAsync(GetMiniaudioEngine(nullptr), filePathOrId, flags, std::move(onLoaded));
+	}
+
+	SoundLoad Sound::InitAsync(Engine& engine, const char* filePathOrId, uint32_t flags, SoundLoad::Callback onLoaded)
+	{
+		Reset();
+
+		if (!engine)
+			return {};
+
+		ma_resource_manager* resourceManager = ma_engine_get_resource_manager(engine.get());
+		if (!JPL_ENSURE(resourceManager, "Loading sounds asynchronously requires the engine to have a resource manager."))
+			return {};
+
+		// Force disable miniaudio's spatialization, we use our own spatializer
+		flags |= MA_SOUND_FLAG_NO_SPATIALIZATION | MA_SOUND_FLAG_ASYNC;
+
+		auto state = std::make_shared<Internal::AsyncLoadState>();
+		state->OnLoaded = std::move(onLoaded);
+
+		ma_resource_manager_pipeline_notifications notifications = ma_resource_manager_pipeline_notifications_init();
+		notifications.done.pNotification = &state->Notification;
+		notifications.done.pFence = &state->Fence;
+
+		// Same values for the resource manager and sound flags
+		static constexpr uint32_t dataSourceFlags = MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_STREAM
+												  | MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_DECODE
+												  | MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_ASYNC
+												  | MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_WAIT_INIT;
+
+		ma_resource_manager_data_source_config dataSourceConfig = ma_resource_manager_data_source_config_init();
+		dataSourceConfig.pFilePath = filePathOrId;
+		// The sound needs the data format right away, so wait for the header like miniaudio does
+		// for files. Decoding still happens on the job threads.
+		dataSourceConfig.flags = (flags & dataSourceFlags) | MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_WAIT_INIT;
+		dataSourceConfig.pNotifications = &notifications;
+
+		// The fence is acquired before the job is posted
+		state->bPending = true;
+
+		if (!JPL_ENSURE(ma_resource_manager_data_source_init_ex(resourceManager, &dataSourceConfig, &state->DataSource) == MA_SUCCESS))
+		{
+			// Nothing was posted to the job threads, don't wait for the fence
+			state->bPending = false;
+			return {};
+		}
+		state->bDataSourceInitialized = true;
+
+		allocate();
+
+		ma_sound_config config = ma_sound_config_init_2(engine.get());
+		config.pDataSource = &state->DataSource;
+		config.flags = flags & ~dataSourceFlags;
+
+		ma_result result = ma_sound_init_ex(engine.get(), &config, get());
+		if (!JPL_ENSURE(!result))
+		{
+			// Load is still in flight, the state waits for it when released
+			discard();
+			return {};
+		}
+
+		mLoadState = state;
+		return SoundLoad(std::move(state));
+	}
+
 	void Sound::SetVolume(float volume)
 	{
 		ma_sound_set_volume(get(), volume);
@@ -348,6 +826,50 @@ namespace JPL
 		return ma_sound_start(get()) == MA_SUCCESS;
 	}
 
+	bool Sound::StartAtFrame(uint64_t engineTimeInFrames)
+	{
+		ClearStopTime();
+		ma_sound_set_start_time_in_pcm_frames(get(), engineTimeInFrames);
+		return Start();
+	}
+
+	bool Sound::StartAtMilliseconds(uint64_t engineTimeInMilliseconds)
+	{
+		ClearStopTime();
+		ma_sound_set_start_time_in_milliseconds(get(), engineTimeInMilliseconds);
+		return Start();
+	}
+
+	void Sound::StopAtFrame(uint64_t engineTimeInFrames, uint64_t fadeLengthInFrames)
+	{
+		ma_sound_set_stop_time_with_fade_in_pcm_frames(get(), engineTimeInFrames, fadeLengthInFrames);
+	}
+
+	void Sound::StopAtMilliseconds(uint64_t engineTimeInMilliseconds)
+	{
+		ma_sound_set_stop_time_in_milliseconds(get(), engineTimeInMilliseconds);
+	}
+
+	void Sound::ClearStopTime()
+	{
+		ma_sound_set_stop_time_in_pcm_frames(get(), std::numeric_limits<ma_uint64>::max());
+	}
+
+	uint64_t Sound::GetTimeInFrames() const
+	{
+		return ma_sound_get_time_in_pcm_frames(get());
+	}
+
+	uint64_t Sound::GetTimeInMilliseconds() const
+	{
+		return ma_sound_get_time_in_milliseconds(get());
+	}
+
+	void Sound::SetEndCallback(ma_sound_end_proc callback, void* userData)
+	{
+		ma_sound_set_end_callback(get(), callback, userData);
+	}
+
 	bool Sound::Stop()
 	{
 		return ma_sound_stop(get()) == MA_SUCCESS;
@@ -421,13 +943,87 @@ namespace JPL
 		return cursorSeconds;
 	}
 
+	bool Sound::Virtualize()
+	{
+		ma_sound* sound = get();
+		if (!sound || IsVirtual() || !IsPlaying())
+			return false;
+
+		ma_engine* engine = ma_sound_get_engine(sound);
+
+		ma_uint32 sourceSampleRate = 0;
+		ma_sound_get_data_format(sound, nullptr, nullptr, &sourceSampleRate, nullptr, 0);
+		const uint32_t engineSampleRate = ma_engine_get_sample_rate(engine);
+
+		const ma_node_output_bus& outputBus = sound->engineNode.baseNode.pOutputBuses[0];
+
+		mVirtual = VirtualState{
+			.StartTime = ma_engine_get_time_in_pcm_frames(engine),
+			.StartCursor = GetCursorInFrames(),
+			.FramesPerEngineFrame = sourceSampleRate > 0 && engineSampleRate > 0
+				? static_cast<double>(GetPitch()) * sourceSampleRate / engineSampleRate
+				: static_cast<double>(GetPitch()),
+			.OutputNode = outputBus.pInputNode,
+			.OutputNodeInputBus = outputBus.inputNodeInputBusIndex
+		};
+
+		Stop();
+		ma_node_detach_output_bus(sound, 0);
+		return true;
+	}
+
+	bool Sound::Devirtualize()
+	{
+		if (!IsVirtual())
+			return false;
+
+		const uint64_t cursor = GetVirtualCursorInFrames();
+		const VirtualState state = *mVirtual;
+		mVirtual.reset();
+
+		ma_sound* sound = get();
+		if (state.OutputNode)
+			ma_node_attach_output_bus(sound, 0, state.OutputNode, state.OutputNodeInputBus);
+
+		const uint64_t length = GetLengthInFrames();
+		if (!IsLooping() && length > 0 && cursor >= length)
+		{
+			SeekToFrame(length);
+			return true;
+		}
+
+		return SeekToFrame(cursor) && Start();
+	}
+
+	uint64_t Sound::GetVirtualCursorInFrames()
+	{
+		if (!IsVirtual())
+			return GetCursorInFrames();
+
+		const uint64_t engineTime = ma_engine_get_time_in_pcm_frames(ma_sound_get_engine(get()));
+		const uint64_t elapsedEngineFrames = engineTime - mVirtual->StartTime;
+		const uint64_t cursor = mVirtual->StartCursor + static_cast<uint64_t>(elapsedEngineFrames * mVirtual->FramesPerEngineFrame);
+
+		if (IsLooping())
+		{
+			if (const uint64_t length = GetLengthInFrames(); length > 0)
+				return cursor % length;
+		}
+		return cursor;
+	}
+
 	//==========================================================================
 	bool LPFNode::Init(uint32_t numChannels, double cutoffFrequency, uint32_t order, uint32_t sampleRate /*= 0*/)
+	{
+		return Init(GetMiniaudioEngine(nullptr), numChannels, cutoffFrequency, order, sampleRate);
+	}
+
+	bool LPFNode::Init(Engine& engine, uint32_t numChannels, double cutoffFrequency, uint32_t order, uint32_t sampleRate /*= 0*/)
 	{
 		if (numChannels == 0)
 			return false;
 
-		if (Engine& engine = GetMiniaudioEngine(nullptr))
+		if (engine)
 		{
 			if (!sampleRate)
 				sampleRate = engine.GetSampleRate();
@@ -444,8 +1040,7 @@ namespace JPL
 
 			if (!JPL_ENSURE(!result))
 			{
-				ma_lpf_node* node = release();
-				delete node;
+				discard();
 				return false;
 			}
 
@@ -477,7 +1072,12 @@ namespace JPL
 	//==========================================================================
 	bool HPFNode::Init(uint32_t numChannels, double cutoffFrequency, uint32_t order, uint32_t sampleRate)
 	{
-		if (Engine& engine = GetMiniaudioEngine(nullptr))
+		return Init(GetMiniaudioEngine(nullptr), numChannels, cutoffFrequency, order, sampleRate);
+	}
+
+	bool HPFNode::Init(Engine& engine, uint32_t numChannels, double cutoffFrequency, uint32_t order, uint32_t sampleRate)
+	{
+		if (engine)
 		{
 			if (!sampleRate)
 				sampleRate = engine.GetSampleRate();
@@ -494,8 +1094,7 @@ namespace JPL
 
 			if (!JPL_ENSURE(!result))
 			{
-				ma_hpf_node* node = release();
-				delete node;
+				discard();
 				return false;
 			}
 
@@ -0,0 +1,126 @@
+﻿//
+//      ██╗██████╗     ██╗     ██╗██████╗ ███████╗
+//      ██║██╔══██╗    ██║     ██║██╔══██╗██╔════╝		** MiniaudioCpp **
+//      ██║██████╔╝    ██║     ██║██████╔╝███████╗
+// ██   ██║██╔═══╝     ██║     ██║██╔══██╗╚════██║		https://github.com/Jaytheway/MiniaudioCpp
+// ╚█████╔╝██║         ███████╗██║██████╔╝███████║
+//  ╚════╝ ╚═╝         ╚══════╝╚═╝╚═════╝ ╚══════╝
+//
+//   Copyright 2024 Jaroslav Pevno, MiniaudioCpp is offered under the terms of the ISC license:
+//
+//   Permission to use, copy, modify, and/or distribute this software for any purpose with or
+//   without fee is hereby granted, provided that the above copyright notice and this permission
+//   notice appear in all copies. THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+//   WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+//   AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+//   CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+//   WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+//   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#include "NodeProfiler.h"
+
+#include <algorithm>
+#include <format>
+#include <mutex>
+
+namespace JPL
+{
+	namespace
+	{
+		std::mutex& GetRegistryMutex()
+		{
+			static std::mutex sMutex;
+			return sMutex;
+		}
+
+		std::vector<NodeProfiler::Entry*>& GetRegistry()
+		{
+			static std::vector<NodeProfiler::Entry*> sEntries;
+			return sEntries;
+		}
+	}
+
+	NodeProfiler::Entry::Entry(std::string_view name, const void* node)
+		: mName(name)
+		, mNode(node)
+	{
+		std::scoped_lock lock(GetRegistryMutex());
+		GetRegistry().push_back(this);
+	}
+
+	NodeProfiler::Entry::~Entry()
+	{
+		std::scoped_lock lock(GetRegistryMutex());
+		std::vector<Entry*>& registry = GetRegistry();
+		if (auto it = std::ranges::find(registry, this); it != registry.end())
+		{
+			*it = registry.back();
+			registry.pop_back();
+		}
+	}
+
+	std::vector<NodeProfiler::NodeReport> NodeProfiler::GetTopNodes(uint32 maxNodes)
+	{
+		std::vector<NodeReport> reports;
+		{
+			std::scoped_lock lock(GetRegistryMutex());
+
+			const std::vector<Entry*>& registry = GetRegistry();
+			reports.reserve(registry.size());
+
+			for (const Entry* entry : registry)
+			{
+				NodeReport& report = reports.emplace_back();
+				report.Name = entry->mName;
+				report.Node = entry->mNode;
+				report.NumCalls = entry->Stats.NumCalls.load(std::memory_order_relaxed);
+				report.TotalNs = entry->Stats.TotalNs.load(std::memory_order_relaxed);
+				report.PeakNs = entry->Stats.PeakNs.load(std::memory_order_relaxed);
+				report.LastNs = entry->Stats.LastNs.load(std::memory_order_relaxed);
+			}
+		}
+
+		const size_t numTop = std::min(reports.size(), static_cast<size_t>(maxNodes));
+		std::ranges::partial_sort(reports, reports.begin() + numTop, std::ranges::greater{}, &NodeReport::TotalNs);
+		reports.resize(numTop);
+
+		return reports;
+	}
+
+	std::string NodeProfiler::FormatTopNodes(uint32 maxNodes)
+	{
+		const std::vector<NodeReport> reports = GetTopNodes(maxNodes);
+
+		std::string result = std::format("{:<4}{:<48}{:>12}{:>14}{:>12}{:>12}\n", "#", "Node", "Calls", "Total (ms)", "Avg (us)", "Peak (us)");
+		for (size_t i = 0; i < reports.size(); ++i)
+		{
+			const NodeReport& report = reports[i];
+			result += std::format("{:<4}{:<48}{:>12}{:>14.3f}{:>12.2f}{:>12.2f}\n",
+								  i + 1,
+								  std::format("{} ({})", report.Name, report.Node),
+								  report.NumCalls,
+								  static_cast<double>(report.TotalNs) * 1e-6,
+								  report.GetAverageNs() * 1e-3,
+								  static_cast<double>(report.PeakNs) * 1e-3);
+		}
+		return result;
+	}
+
+	uint32 NodeProfiler::GetNumRegisteredNodes()
+	{
+		std::scoped_lock lock(GetRegistryMutex());
+		return static_cast<uint32>(GetRegistry().size());
+	}
+
+	void NodeProfiler::ResetAll()
+	{
+		std::scoped_lock lock(GetRegistryMutex());
+		for (Entry* entry : GetRegistry())
+		{
+			entry->Stats.NumCalls.store(0, std::memory_order_relaxed);
+			entry->Stats.TotalNs.store(0, std::memory_order_relaxed);
+			entry->Stats.PeakNs.store(0, std::memory_order_relaxed);
+			entry->Stats.LastNs.store(0, std::memory_order_relaxed);
+		}
+	}
+} // namespace JPL
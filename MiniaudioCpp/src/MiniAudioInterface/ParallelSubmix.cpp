@@ -0,0 +1,159 @@
+﻿//
+//      ██╗██████╗     ██╗     ██╗██████╗ ███████╗
+//      ██║██╔══██╗    ██║     ██║██╔══██╗██╔════╝		** MiniaudioCpp **
+//      ██║██████╔╝    ██║     ██║██████╔╝███████╗
+// ██   ██║██╔═══╝     ██║     ██║██╔══██╗╚════██║		https://github.com/Jaytheway/MiniaudioCpp
+// ╚█████╔╝██║         ███████╗██║██████╔╝███████║
+//  ╚════╝ ╚═╝         ╚══════╝╚═╝╚═════╝ ╚══════╝
+//
+//   Copyright 2024 Jaroslav Pevno, MiniaudioCpp is offered under the terms of the ISC license:
+//
+//   Permission to use, copy, modify, and/or distribute this software for any purpose with or
+//   without fee is hereby granted, provided that the above copyright notice and this permission
+//   notice appear in all copies. THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+//   WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+//   AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+//   CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+//   WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+//   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#include "ParallelSubmix.h"
+
+#include "WorkStealingPool.h"
+
+#include "DSP.h"
+#include "ErrorReporting.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace JPL
+{
+	// Running more workers than this is unlikely to help,
+	// waking them up would cost more than rendering small submixes
+	static constexpr uint32 cMaxSubmixWorkers = 7;
+
+	ParallelSubmixNode::ParallelSubmixNode() = default;
+	ParallelSubmixNode::~ParallelSubmixNode()
+	{
+		// Detach and stop the node before tearing down the pool and submixes
+		mNode.reset();
+		if (mPool)
+			mPool->Shutdown();
+	}
+
+	bool ParallelSubmixNode::Init(Engine& engine, const SubmixSettings& settings)
+	{
+		if (!JPL_ENSURE(!IsInitialized(), "ParallelSubmixNode is already initialized."))
+			return false;
+
+		if (!engine || settings.NumSubmixes == 0)
+			return false;
+
+		mNumChannels = settings.NumChannels > 0 ? settings.NumChannels : engine.GetNumChannels();
+		mMaxBlockSize = engine.GetProcessingSizeInFrames();
+
+		mSubmixes = std::vector<Engine>(settings.NumSubmixes);
+		for (Engine& submix : mSubmixes)
+		{
+			const Engine::EngineSettings submixSettings
+			{
+				.NumChannels = mNumChannels,
+				.SampleRate = engine.GetSampleRate(),
+				.ResourceManager = engine->pResourceManager,
+				.AllocationCallbacks = &engine->allocationCallbacks,
+				.PeriodSizeInFrames = engine->nodeGraph.processingSizeInFrames,
+				.Offline = true
+			};
+
+			if (!submix.Init(submixSettings))
+			{
+				mSubmixes.clear();
+				return false;
+			}
+		}
+
+		mSubmixBuffers.assign(static_cast<size_t>(mMaxBlockSize) * mNumChannels * settings.NumSubmixes, 0.0f);
+
+		uint32 numWorkers = settings.NumWorkerThreads;
+		if (numWorkers == 0)
+		{
+			const uint32 hardwareThreads = std::thread::hardware_concurrency();
+			numWorkers = std::min(hardwareThreads > 1 ? hardwareThreads - 1 : 0u, cMaxSubmixWorkers);
+		}
+
+		// No point having more threads than tasks, the audio thread takes one of the submixes
+		numWorkers = std::min(numWorkers, settings.NumSubmixes - 1);
+
+		mPool = std::make_unique<WorkStealingPool>();
+		mPool->Init(numWorkers);
+
+		if (!mNode.Init(NodeLayout().WithOutputs(mNumChannels).WithEngine(engine)))
+		{
+			mPool.reset();
+			mSubmixes.clear();
+			mSubmixBuffers.clear();
+			return false;
+		}
+
+		mNode->Owner = this;
+		return true;
+	}
+
+	uint32_t ParallelSubmixNode::GetNumWorkerThreads() const
+	{
+		return mPool ? mPool->GetNumWorkers() : 0;
+	}
+
+	void ParallelSubmixNode::MixNode::Process(ProcessCallbackData& data)
+	{
+		auto outputBuffer = data.GetOutputBuffer(0);
+
+		JPL_ASSERT(Owner != nullptr);
+		Owner->RenderSubmixes(outputBuffer.data.data, outputBuffer.getNumFrames());
+	}
+
+	void ParallelSubmixNode::RenderSubmixes(float* output, uint32_t numFrames)
+	{
+		const uint32_t numSubmixes = GetNumSubmixes();
+
+		// Parent graph may ask for more than its processing size,
+		// render in blocks that fit into the submix buffers.
+		for (uint32_t frameOffset = 0; frameOffset < numFrames;)
+		{
+			mCurrentBlockSize = std::min(numFrames - frameOffset, mMaxBlockSize);
+
+			mPool->Run(numSubmixes, &ParallelSubmixNode::RenderSubmixTask, this);
+
+			// Join submixes
+			const size_t blockStride = static_cast<size_t>(mMaxBlockSize) * mNumChannels;
+			const size_t numSamples = static_cast<size_t>(mCurrentBlockSize) * mNumChannels;
+			float* blockOutput = output + static_cast<size_t>(frameOffset) * mNumChannels;
+
+			DSP::Copy(mSubmixBuffers.data(), blockOutput, static_cast<uint32>(numSamples));
+			for (uint32_t submix = 1; submix < numSubmixes; ++submix)
+			{
+				const float* submixBuffer = mSubmixBuffers.data() + submix * blockStride;
+				DSP::Mix(submixBuffer, blockOutput, static_cast<uint32>(numSamples));
+			}
+
+			frameOffset += mCurrentBlockSize;
+		}
+	}
+
+	void ParallelSubmixNode::RenderSubmixTask(void* context, uint32 submixIndex)
+	{
+		auto* self = static_cast<ParallelSubmixNode*>(context);
+
+		const size_t blockStride = static_cast<size_t>(self->mMaxBlockSize) * self->mNumChannels;
+		const size_t numSamples = static_cast<size_t>(self->mCurrentBlockSize) * self->mNumChannels;
+		float* submixBuffer = self->mSubmixBuffers.data() + submixIndex * blockStride;
+
+		const uint64_t numRendered = self->mSubmixes[submixIndex].Render(std::span<float>(submixBuffer, numSamples), self->mCurrentBlockSize);
+
+		// Engine outputs silence when there is nothing to render,
+		// but make sure we don't mix stale data if it returns short.
+		const size_t numRenderedSamples = static_cast<size_t>(numRendered) * self->mNumChannels;
+		std::fill(submixBuffer + numRenderedSamples, submixBuffer + numSamples, 0.0f);
+	}
+} // namespace JPL
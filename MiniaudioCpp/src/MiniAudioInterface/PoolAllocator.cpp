@@ -0,0 +1,459 @@
+﻿//
+//      ██╗██████╗     ██╗     ██╗██████╗ ███████╗
+//      ██║██╔══██╗    ██║     ██║██╔══██╗██╔════╝		** MiniaudioCpp **
+//      ██║██████╔╝    ██║     ██║██████╔╝███████╗
+// ██   ██║██╔═══╝     ██║     ██║██╔══██╗╚════██║		https://github.com/Jaytheway/MiniaudioCpp
+// ╚█████╔╝██║         ███████╗██║██████╔╝███████║
+//  ╚════╝ ╚═╝         ╚══════╝╚═╝╚═════╝ ╚══════╝
+//
+//   Copyright 2024 Jaroslav Pevno, MiniaudioCpp is offered under the terms of the ISC license:
+//
+//   Permission to use, copy, modify, and/or distribute this software for any purpose with or
+//   without fee is hereby granted, provided that the above copyright notice and this permission
+//   notice appear in all copies. THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+//   WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+//   AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+//   CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+//   WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+//   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#include "PoolAllocator.h"
+
+#include "ErrorReporting.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <format>
+
+namespace JPL
+{
+	namespace
+	{
+		// Allocators that are alive, thread caches check it before returning blocks
+		// to the allocator they were bound to. Leaked on purpose, threads may exit
+		// after static destruction.
+		struct AllocatorRegistry
+		{
+			std::mutex Mutex;
+			std::vector<const PoolAllocator*> Allocators;
+		};
+
+		AllocatorRegistry& GetAllocatorRegistry()
+		{
+			static AllocatorRegistry* sRegistry = new AllocatorRegistry();
+			return *sRegistry;
+		}
+
+		std::atomic<uint64> sNextAllocatorId{ 1 };
+	}
+
+	//==========================================================================
+	struct PoolAllocator::ThreadCache
+	{
+		struct Bin
+		{
+			FreeBlock* Head;
+			uint32 Count;
+		};
+
+		PoolAllocator* Owner;
+		uint64 OwnerId;	// 0 - not bound
+		Bin Bins[cNumSizeClasses];
+		bool bExited;
+
+		// Return cached blocks to the owner if it's still alive, and unbind
+		void Flush()
+		{
+			if (OwnerId == 0)
+				return;
+
+			AllocatorRegistry& registry = GetAllocatorRegistry();
+			std::scoped_lock lock(registry.Mutex);
+
+			const bool bOwnerAlive = std::ranges::find(registry.Allocators, Owner) != registry.Allocators.end()
+				&& Owner->mId == OwnerId;
+
+			for (uint32 sizeClass = 0; sizeClass < cNumSizeClasses; ++sizeClass)
+			{
+				Bin& bin = Bins[sizeClass];
+				if (bOwnerAlive && bin.Head)
+				{
+					FreeBlock* tail = bin.Head;
+					while (tail->Next)
+						tail = tail->Next;
+
+					Owner->ReleaseBlocks(sizeClass, bin.Head, tail);
+				}
+				bin = {};
+			}
+
+			Owner = nullptr;
+			OwnerId = 0;
+		}
+	};
+
+	struct PoolAllocator::ThreadCacheFlusher
+	{
+		bool bArmed = false;
+
+		~ThreadCacheFlusher()
+		{
+			sThreadCache.Flush();
+			sThreadCache.bExited = true;
+		}
+	};
+
+	thread_local constinit PoolAllocator::ThreadCache PoolAllocator::sThreadCache{};
+	thread_local PoolAllocator::ThreadCacheFlusher PoolAllocator::sThreadCacheFlusher;
+
+	//==========================================================================
+	PoolAllocator::PoolAllocator()
+		: PoolAllocator(AllocatorSettings{})
+	{
+	}
+
+	PoolAllocator::PoolAllocator(const AllocatorSettings& settings)
+		: mSettings(settings)
+		, mId(sNextAllocatorId.fetch_add(1, std::memory_order_relaxed))
+	{
+		if (IsArena())
+		{
+			if (void* arena = ma_malloc(mSettings.ArenaSizeInBytes, nullptr))
+			{
+				mRegions.push_back(arena);
+				mRegionCursor = static_cast<char*>(arena);
+				mRegionEnd = mRegionCursor + mSettings.ArenaSizeInBytes;
+				mReservedBytes.store(mSettings.ArenaSizeInBytes, std::memory_order_relaxed);
+			}
+			else
+			{
+				JPL_ERROR_TAG("PoolAllocator", std::format("Failed to allocate arena of {} bytes.", mSettings.ArenaSizeInBytes));
+			}
+		}
+
+		for (size_t i = 0; i < mCallbacks.size(); ++i)
+		{
+			mCallbackContexts[i] = { .Allocator = this, .Category = static_cast<EAllocationCategory>(i) };
+			mCallbacks[i] = ma_allocation_callbacks{
+				.pUserData = &mCallbackContexts[i],
+				.onMalloc = &PoolAllocator::MallocCallback,
+				.onRealloc = &PoolAllocator::ReallocCallback,
+				.onFree = &PoolAllocator::FreeCallback
+			};
+		}
+
+		AllocatorRegistry& registry = GetAllocatorRegistry();
+		std::scoped_lock lock(registry.Mutex);
+		registry.Allocators.push_back(this);
+	}
+
+	PoolAllocator::~PoolAllocator()
+	{
+		{
+			// Thread caches still bound to this allocator drop their blocks from now on
+			AllocatorRegistry& registry = GetAllocatorRegistry();
+			std::scoped_lock lock(registry.Mutex);
+			std::erase(registry.Allocators, this);
+		}
+
+		if (const uint64 numBytesInUse = GetTotalAllocatedBytes(); numBytesInUse > 0)
+		{
+			// Better to leak than to pull the memory from under the objects that are still alive
+			JPL_ERROR_TAG("PoolAllocator", std::format("Destroyed while {} bytes are still in use, pooled memory is leaked.", numBytesInUse));
+			return;
+		}
+
+		for (void* region : mRegions)
+			ma_free(region, nullptr);
+	}
+
+	//==========================================================================
+	void* PoolAllocator::Allocate(size_t size, EAllocationCategory category)
+	{
+		const uint64 totalSize = static_cast<uint64>(size) + sizeof(BlockHeader);
+
+		BlockHeader* header = nullptr;
+		uint16 sizeClass = cLargeSizeClass;
+
+		if (totalSize <= cMaxBlockSize)
+		{
+			// 32 -> 0, 64 -> 1, 128 -> 2, ...
+			sizeClass = static_cast<uint16>(std::bit_width((totalSize - 1) / cMinBlockSize));
+			header = reinterpret_cast<BlockHeader*>(PopBlock(sizeClass));
+		}
+		else
+		{
+			header = static_cast<BlockHeader*>(ma_malloc(totalSize, nullptr));
+			if (header)
+				mLargeBytes.fetch_add(size, std::memory_order_relaxed);
+		}
+
+		if (!header)
+		{
+			mCounters[static_cast<size_t>(category)].NumFailed.fetch_add(1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		header->Size = size;
+		header->SizeClass = sizeClass;
+		header->Category = static_cast<uint8>(category);
+
+		OnAllocated(category, size);
+		return header + 1;
+	}
+
+	void* PoolAllocator::Reallocate(void* memory, size_t size, EAllocationCategory category)
+	{
+		if (memory == nullptr)
+			return Allocate(size, category);
+
+		BlockHeader* header = static_cast<BlockHeader*>(memory) - 1;
+
+		// Shrinking, or growing within the same block
+		if (header->SizeClass != cLargeSizeClass && size + sizeof(BlockHeader) <= GetBlockSize(header->SizeClass))
+		{
+			OnFreed(static_cast<EAllocationCategory>(header->Category), header->Size);
+			OnAllocated(category, size);
+
+			header->Size = size;
+			header->Category = static_cast<uint8>(category);
+			return memory;
+		}
+
+		// Original memory is left intact if the allocation fails
+		void* newMemory = Allocate(size, category);
+		if (!newMemory)
+			return nullptr;
+
+		std::memcpy(newMemory, memory, std::min<uint64>(size, header->Size));
+		Free(memory);
+		return newMemory;
+	}
+
+	void PoolAllocator::Free(void* memory)
+	{
+		if (memory == nullptr)
+			return;
+
+		BlockHeader* header = static_cast<BlockHeader*>(memory) - 1;
+		OnFreed(static_cast<EAllocationCategory>(header->Category), header->Size);
+
+		if (header->SizeClass == cLargeSizeClass)
+		{
+			mLargeBytes.fetch_sub(header->Size, std::memory_order_relaxed);
+			ma_free(header, nullptr);
+		}
+		else
+		{
+			PushBlock(header->SizeClass, reinterpret_cast<FreeBlock*>(header));
+		}
+	}
+
+	//==========================================================================
+	PoolAllocator::CategoryStats PoolAllocator::GetStats(EAllocationCategory category) const
+	{
+		const CategoryCounters& counters = mCounters[static_cast<size_t>(category)];
+		return CategoryStats{
+			.CurrentBytes = counters.CurrentBytes.load(std::memory_order_relaxed),
+			.PeakBytes = counters.PeakBytes.load(std::memory_order_relaxed),
+			.NumAllocations = counters.NumAllocations.load(std::memory_order_relaxed),
+			.NumFrees = counters.NumFrees.load(std::memory_order_relaxed),
+			.NumFailed = counters.NumFailed.load(std::memory_order_relaxed)
+		};
+	}
+
+	uint64 PoolAllocator::GetTotalAllocatedBytes() const
+	{
+		uint64 total = 0;
+		for (const CategoryCounters& counters : mCounters)
+			total += counters.CurrentBytes.load(std::memory_order_relaxed);
+		return total;
+	}
+
+	//==========================================================================
+	PoolAllocator::ThreadCache* PoolAllocator::GetThreadCache()
+	{
+		if (mSettings.ThreadCacheSize == 0)
+			return nullptr;
+
+		ThreadCache& cache = sThreadCache;
+		if (cache.bExited)
+			return nullptr;
+
+		if (cache.OwnerId != mId)
+		{
+			// Make sure the cache is flushed when the thread exits
+			sThreadCacheFlusher.bArmed = true;
+
+			cache.Flush();
+			cache.Owner = this;
+			cache.OwnerId = mId;
+		}
+		return &cache;
+	}
+
+	PoolAllocator::FreeBlock* PoolAllocator::PopBlock(uint32 sizeClass)
+	{
+		ThreadCache* cache = GetThreadCache();
+		if (!cache)
+		{
+			FreeBlock* block = nullptr;
+			AcquireBlocks(sizeClass, 1, block);
+			return block;
+		}
+
+		ThreadCache::Bin& bin = cache->Bins[sizeClass];
+		if (!bin.Head)
+		{
+			bin.Count = AcquireBlocks(sizeClass, std::max(mSettings.ThreadCacheSize / 2, 1u), bin.Head);
+			if (!bin.Head)
+				return nullptr;
+		}
+
+		FreeBlock* block = bin.Head;
+		bin.Head = block->Next;
+		--bin.Count;
+		return block;
+	}
+
+	void PoolAllocator::PushBlock(uint32 sizeClass, FreeBlock* block)
+	{
+		ThreadCache* cache = GetThreadCache();
+		if (!cache)
+		{
+			block->Next = nullptr;
+			ReleaseBlocks(sizeClass, block, block);
+			return;
+		}
+
+		ThreadCache::Bin& bin = cache->Bins[sizeClass];
+		block->Next = bin.Head;
+		bin.Head = block;
+		++bin.Count;
+
+		if (bin.Count > mSettings.ThreadCacheSize)
+		{
+			// Return half of the cache, so that blocks freed on a different thread
+			// than they were allocated on don't pile up in one thread
+			const uint32 numToRelease = bin.Count / 2;
+
+			FreeBlock* head = bin.Head;
+			FreeBlock* tail = head;
+			for (uint32 i = 1; i < numToRelease; ++i)
+				tail = tail->Next;
+
+			bin.Head = tail->Next;
+			bin.Count -= numToRelease;
+			ReleaseBlocks(sizeClass, head, tail);
+		}
+	}
+
+	uint32 PoolAllocator::AcquireBlocks(uint32 sizeClass, uint32 maxBlocks, FreeBlock*& outHead)
+	{
+		{
+			SizeClassList& list = mFreeLists[sizeClass];
+			std::scoped_lock lock(list.Mutex);
+
+			if (list.Head)
+			{
+				uint32 numBlocks = 1;
+				FreeBlock* tail = list.Head;
+				while (numBlocks < maxBlocks && tail->Next)
+				{
+					tail = tail->Next;
+					++numBlocks;
+				}
+
+				outHead = list.Head;
+				list.Head = tail->Next;
+				tail->Next = nullptr;
+				return numBlocks;
+			}
+		}
+
+		std::scoped_lock lock(mRegionMutex);
+		return CarveBlocks(sizeClass, maxBlocks, outHead);
+	}
+
+	void PoolAllocator::ReleaseBlocks(uint32 sizeClass, FreeBlock* head, FreeBlock* tail)
+	{
+		SizeClassList& list = mFreeLists[sizeClass];
+		std::scoped_lock lock(list.Mutex);
+		tail->Next = list.Head;
+		list.Head = head;
+	}
+
+	uint32 PoolAllocator::CarveBlocks(uint32 sizeClass, uint32 maxBlocks, FreeBlock*& outHead)
+	{
+		const uint64 blockSize = GetBlockSize(sizeClass);
+
+		if (static_cast<uint64>(mRegionEnd - mRegionCursor) < blockSize)
+		{
+			if (IsArena())
+				return 0;
+
+			// The rest of the current region is wasted, which is less than the largest block
+			const uint64 regionSize = std::max<uint64>(mSettings.RegionSizeInBytes, cMaxBlockSize);
+			void* region = ma_malloc(regionSize, nullptr);
+			if (!region)
+				return 0;
+
+			mRegions.push_back(region);
+			mRegionCursor = static_cast<char*>(region);
+			mRegionEnd = mRegionCursor + regionSize;
+			mReservedBytes.fetch_add(regionSize, std::memory_order_relaxed);
+		}
+
+		const uint32 numBlocks = static_cast<uint32>(std::min<uint64>(maxBlocks, (mRegionEnd - mRegionCursor) / blockSize));
+
+		outHead = reinterpret_cast<FreeBlock*>(mRegionCursor);
+		for (uint32 i = 0; i < numBlocks; ++i)
+		{
+			FreeBlock* block = reinterpret_cast<FreeBlock*>(mRegionCursor + i * blockSize);
+			block->Next = i + 1 < numBlocks ? reinterpret_cast<FreeBlock*>(mRegionCursor + (i + 1) * blockSize) : nullptr;
+		}
+
+		mRegionCursor += numBlocks * blockSize;
+		return numBlocks;
+	}
+
+	//==========================================================================
+	void PoolAllocator::OnAllocated(EAllocationCategory category, uint64 size)
+	{
+		CategoryCounters& counters = mCounters[static_cast<size_t>(category)];
+		counters.NumAllocations.fetch_add(1, std::memory_order_relaxed);
+
+		const uint64 current = counters.CurrentBytes.fetch_add(size, std::memory_order_relaxed) + size;
+		uint64 peak = counters.PeakBytes.load(std::memory_order_relaxed);
+		while (current > peak && !counters.PeakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	void PoolAllocator::OnFreed(EAllocationCategory category, uint64 size)
+	{
+		CategoryCounters& counters = mCounters[static_cast<size_t>(category)];
+		counters.NumFrees.fetch_add(1, std::memory_order_relaxed);
+		counters.CurrentBytes.fetch_sub(size, std::memory_order_relaxed);
+	}
+
+	//==========================================================================
+	void* PoolAllocator::MallocCallback(size_t size, void* userData)
+	{
+		const auto* context = static_cast<const CallbackContext*>(userData);
+		return context->Allocator->Allocate(size, context->Category);
+	}
+
+	void* PoolAllocator::ReallocCallback(void* memory, size_t size, void* userData)
+	{
+		const auto* context = static_cast<const CallbackContext*>(userData);
+		return context->Allocator->Reallocate(memory, size, context->Category);
+	}
+
+	void PoolAllocator::FreeCallback(void* memory, void* userData)
+	{
+		const auto* context = static_cast<const CallbackContext*>(userData);
+		context->Allocator->Free(memory);
+	}
+} // namespace JPL
@@ -0,0 +1,83 @@
+﻿//
+//      ██╗██████╗     ██╗     ██╗██████╗ ███████╗
+//      ██║██╔══██╗    ██║     ██║██╔══██╗██╔════╝		** MiniaudioCpp **
+//      ██║██████╔╝    ██║     ██║██████╔╝███████╗
+// ██   ██║██╔═══╝     ██║     ██║██╔══██╗╚════██║		https://github.com/Jaytheway/MiniaudioCpp
+// ╚█████╔╝██║         ███████╗██║██████╔╝███████║
+//  ╚════╝ ╚═╝         ╚══════╝╚═╝╚═════╝ ╚══════╝
+//
+//   Copyright 2024 Jaroslav Pevno, MiniaudioCpp is offered under the terms of the ISC license:
+//
+//   Permission to use, copy, modify, and/or distribute this software for any purpose with or
+//   without fee is hereby granted, provided that the above copyright notice and this permission
+//   notice appear in all copies. THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+//   WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+//   AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+//   CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+//   WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+//   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#include "RealtimeLog.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace JPL
+{
+	RealtimeLog::RealtimeLog(uint32 capacity)
+		: mSlots(std::make_unique<Slot[]>(std::bit_ceil(std::max(capacity, 2u))))
+		, mMask(std::bit_ceil(std::max(capacity, 2u)) - 1)
+	{
+		for (uint64 i = 0; i <= mMask; ++i)
+			mSlots[i].Sequence.store(i, std::memory_order_relaxed);
+	}
+
+	bool RealtimeLog::Push(uint32 level, const char* message)
+	{
+		uint64 index = mWriteIndex.load(std::memory_order_relaxed);
+		Slot* slot = nullptr;
+
+		while (true)
+		{
+			slot = &mSlots[index & mMask];
+			const uint64 sequence = slot->Sequence.load(std::memory_order_acquire);
+			const int64_t difference = static_cast<int64_t>(sequence - index);
+
+			if (difference == 0)
+			{
+				// Slot is free for this lap, try to claim it
+				if (mWriteIndex.compare_exchange_weak(index, index + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (difference < 0)
+			{
+				// Consumer hasn't freed the slot from the previous lap yet
+				mNumDropped.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			else
+			{
+				// Another producer claimed this slot
+				index = mWriteIndex.load(std::memory_order_relaxed);
+			}
+		}
+
+		Record& record = slot->Data;
+		record.Level = level;
+
+		uint32 length = 0;
+		if (message)
+		{
+			for (const char* c = message; *c != '\0' && length < cMaxMessageLength; ++c)
+			{
+				if (*c != '\n' && *c != '\r' && *c != '{' && *c != '}')
+					record.Message[length++] = *c;
+			}
+		}
+		record.Message[length] = '\0';
+		record.Length = length;
+
+		slot->Sequence.store(index + 1, std::memory_order_release);
+		return true;
+	}
+} // namespace JPL
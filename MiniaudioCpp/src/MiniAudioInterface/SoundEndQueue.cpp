@@ -0,0 +1,184 @@
+﻿//
+//      ██╗██████╗     ██╗     ██╗██████╗ ███████╗
+//      ██║██╔══██╗    ██║     ██║██╔══██╗██╔════╝		** MiniaudioCpp **
+//      ██║██████╔╝    ██║     ██║██████╔╝███████╗
+// ██   ██║██╔═══╝     ██║     ██║██╔══██╗╚════██║		https://github.com/Jaytheway/MiniaudioCpp
+// ╚█████╔╝██║         ███████╗██║██████╔╝███████║
+//  ╚════╝ ╚═╝         ╚══════╝╚═╝╚═════╝ ╚══════╝
+//
+//   Copyright 2024 Jaroslav Pevno, MiniaudioCpp is offered under the terms of the ISC license:
+//
+//   Permission to use, copy, modify, and/or distribute this software for any purpose with or
+//   without fee is hereby granted, provided that the above copyright notice and this permission
+//   notice appear in all copies. THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+//   WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+//   AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+//   CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+//   WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+//   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#include "SoundEndQueue.h"
+
+#include "ErrorReporting.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace JPL
+{
+	SoundEndQueue::SoundEndQueue(uint32 capacity)
+		: mCells(std::make_unique<Cell[]>(std::bit_ceil(std::max(capacity, 1u))))
+		, mMask(std::bit_ceil(std::max(capacity, 1u)) - 1)
+	{
+		for (uint64 i = 0; i <= mMask; ++i)
+			mCells[i].Sequence.store(i, std::memory_order_relaxed);
+	}
+
+	SoundEndQueue::~SoundEndQueue()
+	{
+		while (!mWatchedSounds.empty())
+			RemoveWatcher(*mWatchedSounds.begin()->second);
+	}
+
+	//==========================================================================
+	bool SoundEndQueue::Watch(Sound& sound)
+	{
+		if (!sound)
+			return false;
+
+		if (!IsWatched(sound))
+			AddWatcher(sound);
+
+		return true;
+	}
+
+	Sound* SoundEndQueue::WatchAndRelease(std::unique_ptr<Sound> sound)
+	{
+		if (!sound || !*sound)
+			return nullptr;
+
+		Sound* instance = sound.get();
+		if (auto it = mWatchedSounds.find(instance); it != mWatchedSounds.end())
+			it->second->Owned = std::move(sound);
+		else
+			AddWatcher(*instance)->Owned = std::move(sound);
+
+		return instance;
+	}
+
+	void SoundEndQueue::Unwatch(Sound& sound)
+	{
+		if (auto it = mWatchedSounds.find(&sound); it != mWatchedSounds.end())
+			RemoveWatcher(*it->second);
+	}
+
+	//==========================================================================
+	void SoundEndQueue::OnSoundEnd(void* userData, ma_sound* sound)
+	{
+		auto* watcher = static_cast<Watcher*>(userData);
+		SoundEndQueue& queue = *watcher->Queue;
+
+		const EndEvent event{
+			.Source = watcher,
+			.Generation = watcher->Generation.load(std::memory_order_acquire),
+			.Sound = sound
+		};
+
+		if (!queue.Push(event))
+			queue.mNumDropped.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	bool SoundEndQueue::Push(const EndEvent& event)
+	{
+		uint64 position = mEnqueuePosition.load(std::memory_order_relaxed);
+		Cell* cell = nullptr;
+
+		for (;;)
+		{
+			cell = &mCells[position & mMask];
+			const uint64 sequence = cell->Sequence.load(std::memory_order_acquire);
+			const int64_t difference = static_cast<int64_t>(sequence - position);
+
+			if (difference == 0)
+			{
+				// The cell is free, claim it
+				if (mEnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (difference < 0)
+			{
+				// The consumer hasn't got to this cell yet, the queue is full
+				return false;
+			}
+			else
+			{
+				// Another producer claimed the cell
+				position = mEnqueuePosition.load(std::memory_order_relaxed);
+			}
+		}
+
+		cell->Event = event;
+		cell->Sequence.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool SoundEndQueue::Pop(EndEvent& outEvent)
+	{
+		Cell& cell = mCells[mDequeuePosition & mMask];
+		if (cell.Sequence.load(std::memory_order_acquire) != mDequeuePosition + 1)
+			return false;
+
+		outEvent = cell.Event;
+
+		// Hand the cell back to the producers for the next lap
+		cell.Sequence.store(mDequeuePosition + mMask + 1, std::memory_order_release);
+		++mDequeuePosition;
+		return true;
+	}
+
+	//==========================================================================
+	SoundEndQueue::Watcher* SoundEndQueue::AddWatcher(Sound& sound)
+	{
+		Watcher* watcher = nullptr;
+		if (!mFreeWatchers.empty())
+		{
+			watcher = mFreeWatchers.back();
+			mFreeWatchers.pop_back();
+		}
+		else
+		{
+			watcher = mWatchers.emplace_back(std::make_unique<Watcher>()).get();
+			watcher->Queue = this;
+		}
+
+		watcher->Instance = &sound;
+		mWatchedSounds.emplace(&sound, watcher);
+
+		sound.SetEndCallback(OnSoundEnd, watcher);
+		return watcher;
+	}
+
+	void SoundEndQueue::RemoveWatcher(Watcher& watcher)
+	{
+		watcher.Instance->SetEndCallback(nullptr, nullptr);
+
+		// Events already in the queue refer to the previous generation
+		watcher.Generation.fetch_add(1, std::memory_order_release);
+
+		mWatchedSounds.erase(watcher.Instance);
+		watcher.Instance = nullptr;
+		watcher.Owned.reset();
+
+		mFreeWatchers.push_back(&watcher);
+	}
+
+	SoundEndQueue::Watcher* SoundEndQueue::Resolve(const EndEvent& event) const
+	{
+		Watcher* watcher = event.Source;
+		if (watcher->Generation.load(std::memory_order_relaxed) != event.Generation || !watcher->Instance)
+			return nullptr;
+
+		// Guards against the sound having been reinitialized while watched
+		return watcher->Instance->get() == event.Sound ? watcher : nullptr;
+	}
+} // namespace JPL
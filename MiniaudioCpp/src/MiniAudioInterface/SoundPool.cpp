@@ -0,0 +1,163 @@
+﻿//
+//      ██╗██████╗     ██╗     ██╗██████╗ ███████╗
+//      ██║██╔══██╗    ██║     ██║██╔══██╗██╔════╝		** MiniaudioCpp **
+//      ██║██████╔╝    ██║     ██║██████╔╝███████╗
+// ██   ██║██╔═══╝     ██║     ██║██╔══██╗╚════██║		https://github.com/Jaytheway/MiniaudioCpp
+// ╚█████╔╝██║         ███████╗██║██████╔╝███████║
+//  ╚════╝ ╚═╝         ╚══════╝╚═╝╚═════╝ ╚══════╝
+//
+//   Copyright 2024 Jaroslav Pevno, MiniaudioCpp is offered under the terms of the ISC license:
+//
+//   Permission to use, copy, modify, and/or distribute this software for any purpose with or
+//   without fee is hereby granted, provided that the above copyright notice and this permission
+//   notice appear in all copies. THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+//   WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+//   AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+//   CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+//   WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+//   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#include "SoundPool.h"
+
+#include "ErrorReporting.h"
+
+#include "c89atomic.h"
+
+namespace JPL
+{
+	bool SoundPool::Init(Engine& engine, const char* filePathOrId, uint32 capacity, uint32 flags)
+	{
+		if (!JPL_ENSURE(!IsInitialized(), "SoundPool is already initialized."))
+			return false;
+
+		if (!JPL_ENSURE(!(flags & MA_SOUND_FLAG_STREAM), "Streamed sounds can't be pooled."))
+			return false;
+
+		if (capacity == 0)
+			return false;
+
+		// Decode once, all of the instances read from the same buffer
+		flags |= MA_SOUND_FLAG_DECODE;
+
+		if (!mSource.Init(engine, filePathOrId, flags))
+			return false;
+
+		mInstances = std::make_unique<Sound[]>(capacity);
+		for (uint32 i = 0; i < capacity; ++i)
+		{
+			if (!mInstances[i].InitCopy(mSource, flags))
+			{
+				mInstances.reset();
+				mSource.clear();
+				return false;
+			}
+		}
+
+		mCapacity = capacity;
+		mUsedInstances.reserve(capacity);
+		mFreeInstances.reserve(capacity);
+
+		// Hand out the lower indices first
+		for (uint32 i = capacity; i-- > 0;)
+			mFreeInstances.push_back(i);
+
+		return true;
+	}
+
+	//==========================================================================
+	Sound* SoundPool::Acquire()
+	{
+		if (!IsInitialized())
+			return nullptr;
+
+		if (mFreeInstances.empty())
+			Update();
+
+		if (mFreeInstances.empty())
+			return nullptr;
+
+		const uint32 index = mFreeInstances.back();
+		mFreeInstances.pop_back();
+		mUsedInstances.push_back(index);
+
+		Sound& sound = mInstances[index];
+		sound.SetVolume(1.0f);
+		sound.SetPitch(1.0f);
+		sound.SetLooping(false);
+		sound.SetFadeInFrames(1.0f, 1.0f, 0);
+		sound.SeekToFrame(0);
+
+		// Released instance may have been scheduled, e.g. stopped with a fade when stolen
+		sound.ClearStopTime();
+		ma_sound_set_start_time_in_pcm_frames(sound.get(), 0);
+
+		// miniaudio only clears the end state when the sound is started, and the seek is applied
+		// by the audio thread, so a reclaimed instance would still be at its end until started,
+		// and reclaimed by Update again while the caller holds it.
+		// The instance is stopped, the audio thread doesn't touch it.
+		c89atomic_store_explicit_32(&sound.get()->atEnd, MA_FALSE, c89atomic_memory_order_release);
+		return &sound;
+	}
+
+	Sound* SoundPool::Play()
+	{
+		Sound* sound = Acquire();
+		if (sound && !sound->Start())
+		{
+			Release(*sound);
+			return nullptr;
+		}
+		return sound;
+	}
+
+	void SoundPool::Release(Sound& sound)
+	{
+		const int32_t instance = FindInstance(sound);
+		if (!JPL_ENSURE(instance >= 0, "Sound is not from this pool."))
+			return;
+
+		for (uint32 i = 0; i < mUsedInstances.size(); ++i)
+		{
+			if (mUsedInstances[i] == static_cast<uint32>(instance))
+			{
+				ReleaseUsed(i);
+				return;
+			}
+		}
+	}
+
+	void SoundPool::Update()
+	{
+		// Acquired instances are not at their end until started and played through
+		for (uint32 i = static_cast<uint32>(mUsedInstances.size()); i-- > 0;)
+		{
+			if (mInstances[mUsedInstances[i]].IsAtEnd())
+				ReleaseUsed(i);
+		}
+	}
+
+	void SoundPool::StopAll()
+	{
+		while (!mUsedInstances.empty())
+			ReleaseUsed(static_cast<uint32>(mUsedInstances.size() - 1));
+	}
+
+	//==========================================================================
+	int32_t SoundPool::FindInstance(const Sound& sound) const
+	{
+		if (!mInstances || &sound < &mInstances[0] || &sound >= &mInstances[0] + mCapacity)
+			return -1;
+
+		return static_cast<int32_t>(&sound - &mInstances[0]);
+	}
+
+	void SoundPool::ReleaseUsed(uint32 usedIndex)
+	{
+		const uint32 instance = mUsedInstances[usedIndex];
+		mUsedInstances[usedIndex] = mUsedInstances.back();
+		mUsedInstances.pop_back();
+
+		mInstances[instance].Stop();
+		mFreeInstances.push_back(instance);
+	}
+} // namespace JPL
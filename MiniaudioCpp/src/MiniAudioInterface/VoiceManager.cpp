@@ -0,0 +1,357 @@
+﻿//
+//      ██╗██████╗     ██╗     ██╗██████╗ ███████╗
+//      ██║██╔══██╗    ██║     ██║██╔══██╗██╔════╝		** MiniaudioCpp **
+//      ██║██████╔╝    ██║     ██║██████╔╝███████╗
+// ██   ██║██╔═══╝     ██║     ██║██╔══██╗╚════██║		https://github.com/Jaytheway/MiniaudioCpp
+// ╚█████╔╝██║         ███████╗██║██████╔╝███████║
+//  ╚════╝ ╚═╝         ╚══════╝╚═╝╚═════╝ ╚══════╝
+//
+//   Copyright 2024 Jaroslav Pevno, MiniaudioCpp is offered under the terms of the ISC license:
+//
+//   Permission to use, copy, modify, and/or distribute this software for any purpose with or
+//   without fee is hereby granted, provided that the above copyright notice and this permission
+//   notice appear in all copies. THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+//   WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+//   AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+//   CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+//   WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+//   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#include "VoiceManager.h"
+
+#include "ErrorReporting.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace JPL
+{
+	VoiceManager::~VoiceManager()
+	{
+		// Don't leave sounds silenced or scheduled to stop
+		while (!mReleasingVoices.empty())
+			FinishReleasing(static_cast<uint32>(mReleasingVoices.size() - 1));
+	}
+
+	bool VoiceManager::Init(Engine& engine, const VoiceSettings& settings)
+	{
+		if (!JPL_ENSURE(!IsInitialized(), "VoiceManager is already initialized."))
+			return false;
+
+		if (!engine || settings.MaxVoices == 0)
+			return false;
+
+		mEngine = &engine;
+		mSettings = settings;
+		mStealFadeInFrames = static_cast<uint64>(settings.StealFadeInMilliseconds) * engine.GetSampleRate() / 1000;
+
+		mVoices.reserve(settings.MaxVoices + settings.MaxVirtualVoices);
+		mReleasingVoices.reserve(settings.MaxReleasingVoices);
+		mDevirtualizeQueue.reserve(settings.MaxVoices + settings.MaxVirtualVoices);
+		return true;
+	}
+
+	//==========================================================================
+	void VoiceManager::SetCategoryLimit(uint32 category, uint32 maxVoices)
+	{
+		if (CategoryState* state = FindCategory(category))
+			state->MaxVoices = maxVoices;
+		else
+			mCategories.push_back({ .Category = category, .MaxVoices = maxVoices, .NumVoices = 0 });
+	}
+
+	uint32 VoiceManager::GetCategoryLimit(uint32 category) const
+	{
+		const CategoryState* state = FindCategory(category);
+		return state ? state->MaxVoices : 0;
+	}
+
+	uint32 VoiceManager::GetNumVoices(uint32 category) const
+	{
+		const CategoryState* state = FindCategory(category);
+		return state ? state->NumVoices : 0;
+	}
+
+	bool VoiceManager::IsTracked(const Sound& sound) const
+	{
+		return std::ranges::any_of(mVoices, [&sound](const Voice& voice) { return voice.Instance == &sound; })
+			|| std::ranges::any_of(mReleasingVoices, [&sound](const ReleasingVoice& voice) { return voice.Instance == &sound; });
+	}
+
+	//==========================================================================
+	bool VoiceManager::Play(Sound& sound, const VoiceParams& params)
+	{
+		if (!JPL_ENSURE(IsInitialized(), "VoiceManager is not initialized.") || !sound)
+			return false;
+
+		Remove(sound);
+
+		// Virtual voices have filled up the storage
+		if (IsFull())
+		{
+			++mNumRejected;
+			return false;
+		}
+
+		// Not counted until it's mixed
+		Voice voice{
+			.Instance = &sound,
+			.Priority = params.Priority,
+			.Category = params.Category,
+			.StartTime = mEngine->GetTimeInFrames(),
+			.bVirtual = true
+		};
+
+		// Inaudible sound starts virtual right away, without taking a voice
+		if (IsInaudible(sound))
+		{
+			if (!sound.IsVirtual() && !(sound.Start() && sound.Virtualize()))
+				return false;
+
+			mVoices.push_back(voice);
+			return true;
+		}
+
+		if (!MakeRoom(params, true))
+		{
+			++mNumRejected;
+			return false;
+		}
+
+		const bool bStarted = sound.IsVirtual() ? sound.Devirtualize() : sound.Start();
+		if (!bStarted || !sound.IsPlaying())
+			return false;
+
+		mVoices.push_back(voice);
+		SetVoiceVirtual(mVoices.back(), false);
+		return true;
+	}
+
+	void VoiceManager::Stop(Sound& sound)
+	{
+		Remove(sound);
+		if (sound)
+		{
+			if (sound.IsVirtual())
+				sound.Devirtualize();
+			sound.Stop();
+		}
+	}
+
+	void VoiceManager::Remove(Sound& sound)
+	{
+		for (uint32 i = 0; i < mVoices.size(); ++i)
+		{
+			if (mVoices[i].Instance == &sound)
+			{
+				RemoveVoice(i);
+				return;
+			}
+		}
+
+		for (uint32 i = 0; i < mReleasingVoices.size(); ++i)
+		{
+			if (mReleasingVoices[i].Instance == &sound)
+			{
+				FinishReleasing(i);
+				return;
+			}
+		}
+	}
+
+	void VoiceManager::Update()
+	{
+		mDevirtualizeQueue.clear();
+
+		for (uint32 i = static_cast<uint32>(mVoices.size()); i-- > 0;)
+		{
+			Voice& voice = mVoices[i];
+			Sound& sound = *voice.Instance;
+
+			// May have been virtualized or devirtualized by the user
+			if (voice.bVirtual != sound.IsVirtual())
+				SetVoiceVirtual(voice, sound.IsVirtual());
+
+			if (voice.bVirtual)
+			{
+				// One-shot that would have finished while virtual, leave it stopped at its end
+				const uint64 length = sound.GetLengthInFrames();
+				if (!sound.IsLooping() && length > 0 && sound.GetVirtualCursorInFrames() >= length)
+				{
+					sound.Devirtualize();
+					RemoveVoice(i);
+				}
+				else if (mSettings.VirtualizeVolumeThreshold >= 0.0f && !IsInaudible(sound))
+				{
+					mDevirtualizeQueue.push_back(&sound);
+				}
+			}
+			else if (!sound.IsPlaying())
+			{
+				RemoveVoice(i);
+			}
+			else if (IsInaudible(sound) && sound.Virtualize())
+			{
+				SetVoiceVirtual(voice, true);
+			}
+		}
+
+		const uint64 engineTime = mEngine->GetTimeInFrames();
+		for (uint32 i = static_cast<uint32>(mReleasingVoices.size()); i-- > 0;)
+		{
+			if (engineTime >= mReleasingVoices[i].StopTime || !mReleasingVoices[i].Instance->IsPlaying())
+				FinishReleasing(i);
+		}
+
+		// Stealing reorders the voices, so they are looked up by the sound
+		for (Sound* sound : mDevirtualizeQueue)
+			TryDevirtualize(*sound);
+	}
+
+	void VoiceManager::TryDevirtualize(Sound& sound)
+	{
+		auto it = std::ranges::find(mVoices, &sound, &Voice::Instance);
+		if (it == mVoices.end())
+			return;
+
+		const VoiceParams params{ .Priority = it->Priority, .Category = it->Category };
+
+		// Coming back shouldn't steal from voices of the same priority, they'd keep taking turns
+		if (!MakeRoom(params, false))
+			return;
+
+		// Voices may have been reordered by stealing
+		it = std::ranges::find(mVoices, &sound, &Voice::Instance);
+		if (sound.Devirtualize() && sound.IsPlaying())
+			SetVoiceVirtual(*it, false);
+		else
+			RemoveVoice(static_cast<uint32>(it - mVoices.begin()));
+	}
+
+	//==========================================================================
+	VoiceManager::CategoryState* VoiceManager::FindCategory(uint32 category)
+	{
+		auto it = std::ranges::find(mCategories, category, &CategoryState::Category);
+		return it != mCategories.end() ? &*it : nullptr;
+	}
+
+	const VoiceManager::CategoryState* VoiceManager::FindCategory(uint32 category) const
+	{
+		auto it = std::ranges::find(mCategories, category, &CategoryState::Category);
+		return it != mCategories.end() ? &*it : nullptr;
+	}
+
+	bool VoiceManager::MakeRoom(const VoiceParams& params, bool bStealEqualPriority)
+	{
+		const CategoryState* category = FindCategory(params.Category);
+		const bool bCategoryFull = category && IsCategoryFull(*category);
+		if (!bCategoryFull && mNumRealVoices < mSettings.MaxVoices)
+			return true;
+
+		// Stealing from the same category also makes room globally
+		const int32_t victim = FindVoiceToSteal(params, bCategoryFull, bStealEqualPriority);
+		if (victim < 0)
+			return false;
+
+		StealVoice(static_cast<uint32>(victim));
+		return true;
+	}
+
+	int32_t VoiceManager::FindVoiceToSteal(const VoiceParams& params, bool bSameCategory, bool bStealEqualPriority) const
+	{
+		int32_t victim = -1;
+		int32_t victimPriority = std::numeric_limits<int32_t>::max();
+		float victimVolume = std::numeric_limits<float>::max();
+		uint64 victimStartTime = std::numeric_limits<uint64>::max();
+
+		for (uint32 i = 0; i < mVoices.size(); ++i)
+		{
+			const Voice& voice = mVoices[i];
+			if (voice.bVirtual || (bSameCategory && voice.Category != params.Category))
+				continue;
+
+			// Never steal a voice more important than the new one
+			if (voice.Priority > params.Priority || (voice.Priority == params.Priority && !bStealEqualPriority))
+				continue;
+
+			const float volume = voice.Instance->GetVolume() * voice.Instance->GetCurrentFadeVolume();
+
+			const bool bBetterVictim =
+				voice.Priority < victimPriority ||
+				(voice.Priority == victimPriority && (volume < victimVolume ||
+				(volume == victimVolume && voice.StartTime < victimStartTime)));
+
+			if (bBetterVictim)
+			{
+				victim = static_cast<int32_t>(i);
+				victimPriority = voice.Priority;
+				victimVolume = volume;
+				victimStartTime = voice.StartTime;
+			}
+		}
+
+		return victim;
+	}
+
+	void VoiceManager::StealVoice(uint32 voiceIndex)
+	{
+		Sound& sound = *mVoices[voiceIndex].Instance;
+		RemoveVoice(voiceIndex);
+		++mNumStolen;
+
+		if (mStealFadeInFrames == 0 || mReleasingVoices.size() >= mSettings.MaxReleasingVoices)
+		{
+			sound.Stop();
+			return;
+		}
+
+		// Fade out from the current volume and let the engine stop the sound once faded out
+		const uint64 stopTime = mEngine->GetTimeInFrames() + mStealFadeInFrames;
+		sound.StopAtFrame(stopTime, mStealFadeInFrames);
+
+		mReleasingVoices.push_back({ .Instance = &sound, .StopTime = stopTime });
+	}
+
+	void VoiceManager::RemoveVoice(uint32 voiceIndex)
+	{
+		// Virtual voices are not counted
+		SetVoiceVirtual(mVoices[voiceIndex], true);
+
+		mVoices[voiceIndex] = mVoices.back();
+		mVoices.pop_back();
+	}
+
+	void VoiceManager::SetVoiceVirtual(Voice& voice, bool bVirtual)
+	{
+		if (voice.bVirtual == bVirtual)
+			return;
+
+		voice.bVirtual = bVirtual;
+
+		CategoryState* category = FindCategory(voice.Category);
+		if (bVirtual)
+		{
+			--mNumRealVoices;
+			if (category)
+				--category->NumVoices;
+		}
+		else
+		{
+			++mNumRealVoices;
+			if (category)
+				++category->NumVoices;
+		}
+	}
+
+	void VoiceManager::FinishReleasing(uint32 releasingIndex)
+	{
+		Sound& sound = *mReleasingVoices[releasingIndex].Instance;
+		mReleasingVoices[releasingIndex] = mReleasingVoices.back();
+		mReleasingVoices.pop_back();
+
+		// Restore the sound, so that it plays normally if started again
+		sound.Stop();
+		sound.SetFadeInFrames(1.0f, 1.0f, 0);
+		sound.ClearStopTime();
+	}
+} // namespace JPL
@@ -0,0 +1,158 @@
+﻿//
+//      ██╗██████╗     ██╗     ██╗██████╗ ███████╗
+//      ██║██╔══██╗    ██║     ██║██╔══██╗██╔════╝		** MiniaudioCpp **
+//      ██║██████╔╝    ██║     ██║██████╔╝███████╗
+// ██   ██║██╔═══╝     ██║     ██║██╔══██╗╚════██║		https://github.com/Jaytheway/MiniaudioCpp
+// ╚█████╔╝██║         ███████╗██║██████╔╝███████║
+//  ╚════╝ ╚═╝         ╚══════╝╚═╝╚═════╝ ╚══════╝
+//
+//   Copyright 2024 Jaroslav Pevno, MiniaudioCpp is offered under the terms of the ISC license:
+//
+//   Permission to use, copy, modify, and/or distribute this software for any purpose with or
+//   without fee is hereby granted, provided that the above copyright notice and this permission
+//   notice appear in all copies. THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+//   WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+//   AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+//   CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+//   WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+//   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#include "WorkStealingPool.h"
+
+#include "ErrorReporting.h"
+
+#if defined(JPL_CPU_X86)
+#include <immintrin.h>
+#endif
+
+namespace JPL
+{
+	static JPL_INLINE void SpinPause()
+	{
+#if defined(JPL_CPU_X86)
+		_mm_pause();
+#else
+		std::this_thread::yield();
+#endif
+	}
+
+	void WorkStealingPool::Init(uint32 numWorkers)
+	{
+		Shutdown();
+
+		mStop.store(false, std::memory_order_relaxed);
+		mRanges = std::make_unique<TaskRange[]>(numWorkers + 1);
+
+		mWorkers.reserve(numWorkers);
+		for (uint32 i = 0; i < numWorkers; ++i)
+			mWorkers.emplace_back(&WorkStealingPool::WorkerThread, this, i + 1);
+	}
+
+	void WorkStealingPool::Shutdown()
+	{
+		if (mWorkers.empty())
+			return;
+
+		mStop.store(true, std::memory_order_release);
+		mGeneration.fetch_add(1, std::memory_order_release);
+		mGeneration.notify_all();
+
+		for (std::thread& worker : mWorkers)
+			worker.join();
+
+		mWorkers.clear();
+	}
+
+	void WorkStealingPool::Run(uint32 numTasks, TaskFunction function, void* context)
+	{
+		if (numTasks == 0 || !JPL_ENSURE(function != nullptr))
+			return;
+
+		if (mWorkers.empty())
+		{
+			for (uint32 i = 0; i < numTasks; ++i)
+				function(context, i);
+			return;
+		}
+
+		mFunction = function;
+		mContext = context;
+		mNumPendingTasks.store(numTasks, std::memory_order_relaxed);
+
+		// Split tasks evenly between the threads, the first ranges get the remainder
+		const uint32 numThreads = GetNumWorkers() + 1;
+		const uint32 tasksPerThread = numTasks / numThreads;
+		const uint32 remainder = numTasks % numThreads;
+
+		uint32 begin = 0;
+		for (uint32 i = 0; i < numThreads; ++i)
+		{
+			const uint32 end = begin + tasksPerThread + (i < remainder ? 1 : 0);
+			mRanges[i].Range.store(TaskRange::Pack(begin, end), std::memory_order_release);
+			begin = end;
+		}
+
+		mGeneration.fetch_add(1, std::memory_order_release);
+		mGeneration.notify_all();
+
+		ProcessTasks(0);
+
+		// Wait for the tasks that are still being processed by the workers
+		while (mNumPendingTasks.load(std::memory_order_acquire) != 0)
+			SpinPause();
+	}
+
+	void WorkStealingPool::WorkerThread(uint32 workerIndex)
+	{
+		uint32 generation = mGeneration.load(std::memory_order_acquire);
+
+		while (true)
+		{
+			mGeneration.wait(generation, std::memory_order_acquire);
+			generation = mGeneration.load(std::memory_order_acquire);
+
+			if (mStop.load(std::memory_order_acquire))
+				return;
+
+			ProcessTasks(workerIndex);
+		}
+	}
+
+	void WorkStealingPool::ProcessTasks(uint32 threadIndex)
+	{
+		const uint32 numThreads = GetNumWorkers() + 1;
+
+		// Start with our own range, then steal from the rest
+		for (uint32 i = 0; i < numThreads; ++i)
+		{
+			TaskRange& range = mRanges[(threadIndex + i) % numThreads];
+
+			uint32 taskIndex;
+			while (TryPopTask(range, taskIndex))
+			{
+				// Successful pop synchronizes with the Run call that published the range,
+				// so it's safe to read the task function here.
+				mFunction(mContext, taskIndex);
+				mNumPendingTasks.fetch_sub(1, std::memory_order_release);
+			}
+		}
+	}
+
+	bool WorkStealingPool::TryPopTask(TaskRange& range, uint32& outTaskIndex)
+	{
+		uint64 packed = range.Range.load(std::memory_order_acquire);
+		while (true)
+		{
+			const uint32 begin = static_cast<uint32>(packed);
+			const uint32 end = static_cast<uint32>(packed >> 32);
+			if (begin >= end)
+				return false;
+
+			if (range.Range.compare_exchange_weak(packed, TaskRange::Pack(begin + 1, end), std::memory_order_acq_rel, std::memory_order_acquire))
+			{
+				outTaskIndex = begin;
+				return true;
+			}
+		}
+	}
+} // namespace JPL
@@ -0,0 +1,90 @@
+﻿//
+//      ██╗██████╗     ██╗     ██╗██████╗ ███████╗
+//      ██║██╔══██╗    ██║     ██║██╔══██╗██╔════╝		** MiniaudioCpp **
+//      ██║██████╔╝    ██║     ██║██████╔╝███████╗
+// ██   ██║██╔═══╝     ██║     ██║██╔══██╗╚════██║		https://github.com/Jaytheway/MiniaudioCpp
+// ╚█████╔╝██║         ███████╗██║██████╔╝███████║
+//  ╚════╝ ╚═╝         ╚══════╝╚═╝╚═════╝ ╚══════╝
+//
+//   Copyright 2024 Jaroslav Pevno, MiniaudioCpp is offered under the terms of the ISC license:
+//
+//   Permission to use, copy, modify, and/or distribute this software for any purpose with or
+//   without fee is hereby granted, provided that the above copyright notice and this permission
+//   notice appear in all copies. THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL
+//   WARRANTIES WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY
+//   AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+//   CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+//   WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+//   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+#pragma once
+
+#include "Core.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace JPL
+{
+	//==========================================================================
+	/// Minimal thread pool to run a batch of independent tasks from the audio thread.
+	///
+	/// Tasks of a batch are split into contiguous ranges, one per thread.
+	/// Each thread pops tasks from the front of its own range and, when it runs out,
+	/// steals from the ranges of other threads, so uneven tasks are still balanced.
+	///
+	/// The calling thread participates in processing, and Run doesn't return until
+	/// all of the tasks are done. Run doesn't allocate or lock, but it does wake up
+	/// the workers, which is a (non-blocking) system call on most platforms.
+	class WorkStealingPool
+	{
+	public:
+		using TaskFunction = void(*)(void* context, uint32 taskIndex);
+
+		WorkStealingPool() = default;
+		~WorkStealingPool() { Shutdown(); }
+
+		WorkStealingPool(const WorkStealingPool&) = delete;
+		WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+		// Start 'numWorkers' worker threads, 0 is valid, in which case
+		// all of the tasks are run on the calling thread.
+		void Init(uint32 numWorkers);
+		void Shutdown();
+
+		uint32 GetNumWorkers() const { return static_cast<uint32>(mWorkers.size()); }
+
+		// Run 'numTasks' tasks and wait for all of them to finish.
+		// Must not be called concurrently from multiple threads.
+		void Run(uint32 numTasks, TaskFunction function, void* context);
+
+	private:
+		// Task range packed into a single atomic,
+		// so that the owner and thieves see consistent begin/end pair.
+		struct alignas(JPL_CACHE_LINE_SIZE) TaskRange
+		{
+			std::atomic<uint64> Range{ 0 };
+
+			static constexpr uint64 Pack(uint32 begin, uint32 end) { return (static_cast<uint64>(end) << 32) | begin; }
+		};
+
+		void WorkerThread(uint32 workerIndex);
+
+		// Pop tasks from the range of 'threadIndex' and steal from others until there is nothing left
+		void ProcessTasks(uint32 threadIndex);
+		bool TryPopTask(TaskRange& range, uint32& outTaskIndex);
+
+	private:
+		std::vector<std::thread> mWorkers;
+		std::unique_ptr<TaskRange[]> mRanges; // [0] is for the calling thread, [1..] for workers
+
+		TaskFunction mFunction = nullptr;
+		void* mContext = nullptr;
+
+		alignas(JPL_CACHE_LINE_SIZE) std::atomic<uint32> mGeneration{ 0 };
+		alignas(JPL_CACHE_LINE_SIZE) std::atomic<uint32> mNumPendingTasks{ 0 };
+		std::atomic<bool> mStop{ false };
+	};
+} // namespace JPL
@@ -21,10 +21,22 @@
 
 #ifdef JPL_TEST
 
+#include "MiniaudioCpp/AssetCache.h"
+#include "MiniaudioCpp/CallbackProfiler.h"
+#include "MiniaudioCpp/CommandQueue.h"
 #include "MiniaudioCpp/Core.h"
+#include "MiniaudioCpp/DSP.h"
 #include "MiniaudioCpp/ErrorReporting.h"
+#include "MiniaudioCpp/FPFlushDenormals.h"
 #include "MiniaudioCpp/MiniaudioWrappers.h"
+#include "MiniaudioCpp/NodeProfiler.h"
+#include "MiniaudioCpp/PoolAllocator.h"
+#include "MiniaudioCpp/RealtimeLog.h"
+#include "MiniaudioCpp/SoundEndQueue.h"
+#include "MiniaudioCpp/SoundPool.h"
+#include "MiniaudioCpp/ParallelSubmix.h"
 #include "MiniaudioCpp/VFS.h"
+#include "MiniaudioCpp/VoiceManager.h"
 
 #include "choc/audio/choc_SampleBuffers.h"
 #include "choc/audio/choc_AudioFileFormat_WAV.h"
@@ -32,9 +44,16 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
 #include <fstream>
 #include <filesystem>
+#include <format>
+#include <limits>
 #include <sstream>
+#include <thread>
 
 namespace JPL
 {
@@ -58,6 +77,11 @@ namespace JPL
 			static inline uint64 fakeFileSize = durationInFrames * frameSize;
 
 			explicit WaveformMockReader(const char* filepath)
+				: WaveformMockReader(filepath, durationInFrames)
+			{
+			}
+
+			WaveformMockReader(const char* filepath, uint64 numFrames)
 			{
 				// Create wav file with sinewave
 
@@ -75,7 +99,7 @@ namespace JPL
 				auto sourceData = choc::oscillator::createChannelArray<choc::oscillator::Sine<double>, double>(
 					choc::buffer::Size{
 						.numChannels = sourceNumChannels,
-						.numFrames = durationInFrames
+						.numFrames = static_cast<choc::buffer::FrameCount>(numFrames)
 					},
 					sineFrequency,
 					static_cast<double>(sourceSampleRate));
@@ -166,6 +190,116 @@ namespace JPL
 					onProcess(callback);
 			}
 		};
+
+		// Mixes two stereo inputs into a stereo output
+		using StereoMixLayout = FixedLayout<Buses<2, 2>, Buses<2>>;
+		struct stereo_mix_mock
+		{
+			ma_node_base base;
+			static constexpr int FLAGS = 0;
+			void Process(JPL::TProcessCallbackData<StereoMixLayout>& data)
+			{
+				using CallbackData = JPL::TProcessCallbackData<StereoMixLayout>;
+				static_assert(CallbackData::InputBusCount == 2 && CallbackData::OutputBusCount == 1);
+
+				auto output = data.GetOutputBuffer(0);
+				const auto inputA = data.GetInputBuffer(0);
+				const auto inputB = data.GetInputBuffer(1);
+				for (uint32 frame = 0; frame < output.getNumFrames(); ++frame)
+					for (uint32 channel = 0; channel < StereoMixLayout::OUTPUT_CHANNELS[0]; ++channel)
+						output.getSample(channel, frame) = inputA.getSample(channel, frame) + inputB.getSample(channel, frame);
+			}
+		};
+
+		// Applies different gain to each channel
+		using PlanarStereoLayout = PlanarLayout<Buses<2>, Buses<2>>;
+		struct planar_gain_mock
+		{
+			ma_node_base base;
+			static constexpr int FLAGS = 0;
+			static constexpr std::array<float, 2> Gains{ 0.5f, 2.0f };
+			uint32 MaxBlockSize = 0;
+			void Process(JPL::TProcessCallbackData<PlanarStereoLayout>& data)
+			{
+				MaxBlockSize = std::max(MaxBlockSize, data.GetOutputFrameCount());
+
+				const auto input = data.GetInputBuffer(0);
+				auto output = data.GetOutputBuffer(0);
+				for (uint32 channel = 0; channel < Gains.size(); ++channel)
+				{
+					const float* in = input.data.channels[channel] + input.data.offset;
+					float* out = output.data.channels[channel] + output.data.offset;
+					for (uint32 frame = 0; frame < output.getNumFrames(); ++frame)
+						out[frame] = in[frame] * Gains[channel];
+				}
+			}
+		};
+
+		// Applies gain to the input, in place
+		struct in_place_gain_mock
+		{
+			ma_node_base base;
+			static constexpr int FLAGS = 0;
+			static constexpr bool IN_PLACE = true;
+			static constexpr float Gain = 0.5f;
+			void Process(JPL::ProcessCallbackData& data)
+			{
+				auto buffer = data.GetInPlaceBuffer(0);
+				for (uint32 frame = 0; frame < buffer.getNumFrames(); ++frame)
+					for (uint32 channel = 0; channel < buffer.getNumChannels(); ++channel)
+						buffer.getSample(channel, frame) *= Gain;
+			}
+		};
+
+		// Passes input through, with a tail to be rendered after the input goes silent
+		struct tail_mock
+		{
+			ma_node_base base;
+			static constexpr int FLAGS = 0;
+			static constexpr uint32 TailLength = 300;
+			uint64 NumFramesProcessed = 0;
+			uint32 GetTailLengthInFrames() const { return TailLength; }
+			void Process(JPL::ProcessCallbackData& data)
+			{
+				NumFramesProcessed += data.GetOutputFrameCount();
+				data.CopyInputsToOutputs();
+			}
+		};
+
+		// Records the denormals mode of the audio thread, without setting it itself
+		struct denormals_probe_mock
+		{
+			ma_node_base base;
+			static constexpr int FLAGS = 0;
+			static constexpr bool FLUSH_DENORMALS = false;
+			bool bWasFlushing = false;
+			void Process(JPL::ProcessCallbackData& data)
+			{
+				bWasFlushing = ScopedFlushDenormals::IsEnabled();
+				data.FillOutputWithSilence();
+			}
+		};
+
+		// Keeps every other frame, consuming two input frames per output frame
+		struct decimator_mock
+		{
+			ma_node_base base;
+			static constexpr int FLAGS = MA_NODE_FLAG_DIFFERENT_PROCESSING_RATES;
+			static constexpr uint32 Factor = 2;
+			uint32 GetRequiredInputFrameCount(uint32 outputFrameCount) const { return outputFrameCount * Factor; }
+			void Process(JPL::ProcessCallbackData& data)
+			{
+				const uint32 numFramesOut = std::min(data.GetOutputFrameCount(), data.GetInputFrameCount() / Factor);
+				data.SetInputFrameCount(numFramesOut * Factor);
+				data.SetOutputFrameCount(numFramesOut);
+
+				const auto input = data.GetInputBuffer(0);
+				auto output = data.GetOutputBuffer(0);
+				for (uint32 frame = 0; frame < numFramesOut; ++frame)
+					for (uint32 channel = 0; channel < output.getNumChannels(); ++channel)
+						output.getSample(channel, frame) = input.getSample(channel, frame * Factor);
+			}
+		};
 	};
 
 	JPL_INLINE static bool operator==(const BusConfig& lhs, const BusConfig& rhs)
@@ -557,6 +691,1788 @@ namespace JPL
 		}
 	}
 
+	TEST_F(MiniaudioWrappersTest, EngineOffline)
+	{
+		static constexpr uint32 numChannels = 2;
+		static constexpr uint32 sampleRate = 44'100;
+		static constexpr uint64 numFrames = 1024;
+
+		MA::Engine offlineEngine;
+		ASSERT_TRUE(offlineEngine.Init({ .NumChannels = numChannels, .SampleRate = sampleRate, .VFS = &engineVfs, .Offline = true }));
+
+		// Offline engine doesn't have a device, the format is what we requested
+		EXPECT_TRUE(offlineEngine.IsOffline());
+		EXPECT_TRUE(offlineEngine->pDevice == nullptr);
+		EXPECT_FALSE(engine.IsOffline());
+		EXPECT_EQ(offlineEngine.GetSampleRate(), sampleRate);
+		EXPECT_EQ(offlineEngine.GetNumChannels(), numChannels);
+		EXPECT_EQ(offlineEngine.GetEndpointBus().GetNumChannels(), numChannels);
+
+		// Nothing is attached to the endpoint, we should get silence
+		std::vector<float> output(numFrames * numChannels, 1.0f);
+		EXPECT_EQ(offlineEngine.Render(output, numFrames), numFrames);
+		for (float sample : output)
+			EXPECT_FLOAT_EQ(sample, 0.0f);
+
+		// Output doesn't have space for all of the requested frames
+		EXPECT_EQ(offlineEngine.Render(std::span(output).first(numFrames), numFrames), numFrames / numChannels);
+
+		// Render to file
+		const std::filesystem::path filePath = std::filesystem::temp_directory_path() / "MiniaudioCppOfflineRender.wav";
+		EXPECT_FALSE(offlineEngine.RenderToFile(nullptr, numFrames));
+		EXPECT_TRUE(offlineEngine.RenderToFile(filePath.string().c_str(), numFrames));
+		ASSERT_TRUE(std::filesystem::exists(filePath));
+		EXPECT_GE(std::filesystem::file_size(filePath), numFrames * numChannels * sizeof(float));
+		std::filesystem::remove(filePath);
+	}
+
+	TEST_F(MiniaudioWrappersTest, CustomProcessingSize)
+	{
+		static constexpr uint32 numChannels = 2;
+		static constexpr float generatorValue = 0.25f;
+
+		for (const uint32 periodSize : { 64u, 128u, 1024u })
+		{
+			MA::Engine engineTest;
+			ASSERT_TRUE(engineTest.Init({ .NumChannels = numChannels, .VFS = &engineVfs, .PeriodSizeInFrames = periodSize, .Offline = true }));
+			EXPECT_EQ(engineTest.GetProcessingSizeInFrames(), periodSize);
+
+			// generator -> splitter -> 2 x custom passthrough -> endpoint
+			static constexpr int ZERO_FLAGS = 0;
+			TBaseNode<node_base_mock<ZERO_FLAGS>> generator;
+			ASSERT_TRUE(generator.Init(NodeLayout().WithOutputs(numChannels).WithEngine(engineTest)));
+			generator->onProcess = [](JPL::ProcessCallbackData& data)
+			{
+				auto output = data.GetOutputBuffer(0);
+				for (uint32 frame = 0; frame < output.getNumFrames(); ++frame)
+					for (uint32 channel = 0; channel < output.getNumChannels(); ++channel)
+						output.getSample(channel, frame) = generatorValue;
+			};
+
+			MA::SplitterNode splitter;
+			ASSERT_TRUE(splitter.Init(engineTest, numChannels, 2));
+			ASSERT_TRUE(generator.OutputBus(0).AttachTo(splitter.InputBus(0)));
+
+			bool frameCountsMatch = true;
+			std::array<TBaseNode<node_base_mock<ZERO_FLAGS>>, 2> customNodes;
+			for (uint32 i = 0; i < customNodes.size(); ++i)
+			{
+				ASSERT_TRUE(customNodes[i].Init(NodeLayout().WithInputs(numChannels).WithOutputs(numChannels).WithEngine(engineTest)));
+				customNodes[i]->onProcess = [&frameCountsMatch](JPL::ProcessCallbackData& data)
+				{
+					frameCountsMatch &= data.GetInputFrameCount() == data.GetOutputFrameCount();
+					data.CopyInputsToOutputs();
+				};
+				ASSERT_TRUE(splitter.OutputBus(i).AttachTo(customNodes[i].InputBus(0)));
+				ASSERT_TRUE(customNodes[i].OutputBus(0).AttachTo(engineTest.GetEndpointBus()));
+			}
+
+			// Odd number of frames to not align with the processing size
+			static constexpr uint64 numFrames = 3'001;
+			std::vector<float> output(numFrames * numChannels);
+			EXPECT_EQ(engineTest.Render(output, numFrames), numFrames);
+			EXPECT_TRUE(frameCountsMatch);
+
+			for (const float sample : output)
+				EXPECT_FLOAT_EQ(sample, generatorValue * 2.0f);
+		}
+	}
+
+	TEST_F(MiniaudioWrappersTest, FixedLayoutNode)
+	{
+		static_assert(StereoMixLayout::NUM_INPUT_BUSES == 2 && StereoMixLayout::NUM_OUTPUT_BUSES == 1);
+		static_assert(StereoMixLayout::INPUT_CHANNELS[1] == 2);
+		static_assert(!TBaseNode<node_base_mock<0>>::IS_FIXED_LAYOUT);
+		static_assert(TBaseNode<stereo_mix_mock, StereoMixLayout>::IS_FIXED_LAYOUT);
+
+		static constexpr uint32 numChannels = 2;
+
+		MA::Engine engineTest;
+		ASSERT_TRUE(engineTest.Init({ .NumChannels = numChannels, .VFS = &engineVfs, .Offline = true }));
+
+		// Bus configuration must match the fixed layout
+		{
+			TBaseNode<stereo_mix_mock, StereoMixLayout> mismatchedNode;
+			EXPECT_FALSE(mismatchedNode.Init(NodeLayout().WithInputs({ 2, 1 }).WithOutputs(2).WithEngine(engineTest)));
+			EXPECT_FALSE(mismatchedNode.Init(NodeLayout().WithInputs(2).WithOutputs(2).WithEngine(engineTest)));
+			EXPECT_TRUE(mismatchedNode.Init(NodeLayout().WithInputs({ 2, 2 }).WithOutputs(2).WithEngine(engineTest)));
+		}
+
+		// Layout comes from the node type
+		TBaseNode<stereo_mix_mock, StereoMixLayout> mixNode;
+		ASSERT_TRUE(mixNode.Init(engineTest));
+		EXPECT_EQ(mixNode.GetNumInputBusses(), 2);
+		EXPECT_EQ(mixNode.GetNumOutputBusses(), 1);
+		EXPECT_EQ(mixNode.InputBus(1).GetNumChannels(), 2);
+		EXPECT_EQ(mixNode.OutputBus(0).GetNumChannels(), 2);
+
+		// 2 x generator -> mix -> endpoint
+		static constexpr std::array<float, 2> generatorValues{ 0.25f, 0.125f };
+		std::array<TBaseNode<node_base_mock<0>>, 2> generators;
+		for (uint32 i = 0; i < generators.size(); ++i)
+		{
+			ASSERT_TRUE(generators[i].Init(NodeLayout().WithOutputs(numChannels).WithEngine(engineTest)));
+			generators[i]->onProcess = [value = generatorValues[i]](JPL::ProcessCallbackData& data)
+			{
+				auto output = data.GetOutputBuffer(0);
+				for (uint32 frame = 0; frame < output.getNumFrames(); ++frame)
+					for (uint32 channel = 0; channel < output.getNumChannels(); ++channel)
+						output.getSample(channel, frame) = value;
+			};
+			ASSERT_TRUE(generators[i].OutputBus(0).AttachTo(mixNode.InputBus(i)));
+		}
+		ASSERT_TRUE(mixNode.OutputBus(0).AttachTo(engineTest.GetEndpointBus()));
+
+		static constexpr uint64 numFrames = 512;
+		std::vector<float> output(numFrames * numChannels);
+		EXPECT_EQ(engineTest.Render(output, numFrames), numFrames);
+
+		for (const float sample : output)
+			EXPECT_FLOAT_EQ(sample, generatorValues[0] + generatorValues[1]);
+	}
+
+	TEST_F(MiniaudioWrappersTest, DSP)
+	{
+		// Best instruction set is selected by default
+		EXPECT_TRUE(DSP::IsSupported(DSP::EInstructionSet::Scalar));
+		EXPECT_TRUE(DSP::IsSupported(DSP::GetInstructionSet()));
+		EXPECT_FALSE(DSP::IsSupported(static_cast<DSP::EInstructionSet>(-1)));
+
+		// Odd number of samples to go through both the vector loops and the scalar tail,
+		// longer than two of the widest vectors
+		static constexpr uint32 numSamples = 37;
+
+		// Every kernel set the host supports must produce the same results
+		for (const auto instructionSet : { DSP::EInstructionSet::Scalar, DSP::EInstructionSet::SSE2, DSP::EInstructionSet::AVX2, DSP::EInstructionSet::AVX512, DSP::EInstructionSet::NEON })
+		{
+			if (!DSP::SetInstructionSet(instructionSet))
+				continue;
+
+			SCOPED_TRACE(DSP::GetInstructionSetName());
+			EXPECT_EQ(DSP::GetInstructionSet(), instructionSet);
+
+			std::vector<float> source(numSamples);
+			for (uint32 i = 0; i < numSamples; ++i)
+				source[i] = static_cast<float>(i) * (i % 2 ? -0.25f : 0.25f);
+
+			// Copy, silence
+			std::vector<float> buffer(numSamples, 1.0f);
+			DSP::Copy(source.data(), buffer.data(), numSamples);
+			EXPECT_EQ(buffer, source);
+			DSP::Silence(buffer.data(), numSamples);
+			EXPECT_TRUE(std::ranges::all_of(buffer, [](float sample) { return sample == 0.0f; }));
+
+			// Mix, mix with gain
+			std::vector<float> mix(numSamples, 1.0f);
+			DSP::Mix(source.data(), mix.data(), numSamples);
+			DSP::MixWithGain(source.data(), mix.data(), numSamples, 0.5f);
+			for (uint32 i = 0; i < numSamples; ++i)
+				EXPECT_FLOAT_EQ(mix[i], 1.0f + source[i] * 1.5f);
+
+			// Gain
+			buffer = source;
+			DSP::ApplyGain(buffer.data(), numSamples, -2.0f);
+			for (uint32 i = 0; i < numSamples; ++i)
+				EXPECT_FLOAT_EQ(buffer[i], source[i] * -2.0f);
+
+			// Gain ramp steps per frame, and ends one frame short of the end gain
+			for (const uint32 numChannels : { 1u, 2u, 3u })
+			{
+				const uint32 numFrames = numSamples / numChannels;
+				std::vector<float> ones(numFrames * numChannels, 1.0f);
+				DSP::ApplyGainRamp(ones.data(), numChannels, numFrames, 0.0f, 1.0f);
+				for (uint32 frame = 0; frame < numFrames; ++frame)
+					for (uint32 channel = 0; channel < numChannels; ++channel)
+						EXPECT_NEAR(ones[frame * numChannels + channel], static_cast<float>(frame) / numFrames, 1e-6f);
+			}
+
+			// Clamp, peak
+			buffer = source;
+			DSP::Clamp(buffer.data(), numSamples, -1.0f, 2.0f);
+			for (uint32 i = 0; i < numSamples; ++i)
+				EXPECT_FLOAT_EQ(buffer[i], std::clamp(source[i], -1.0f, 2.0f));
+
+			EXPECT_FLOAT_EQ(DSP::FindPeak(source.data(), numSamples), 9.0f);	// 0.25 * 36
+			EXPECT_FLOAT_EQ(DSP::FindPeak(source.data(), 3), 0.5f);
+			EXPECT_FLOAT_EQ(DSP::FindPeak(source.data(), 0), 0.0f);
+
+			// Interleaving
+			for (const uint32 numChannels : { 1u, 2u, 3u })
+			{
+				static constexpr uint32 numFrames = numSamples;
+
+				std::vector<float> interleaved(numFrames * numChannels);
+				for (uint32 i = 0; i < interleaved.size(); ++i)
+					interleaved[i] = static_cast<float>(i);
+
+				std::vector<std::vector<float>> planar(numChannels, std::vector<float>(numFrames));
+				std::vector<float*> channels;
+				for (auto& channel : planar)
+					channels.push_back(channel.data());
+
+				DSP::Deinterleave(interleaved.data(), channels.data(), numChannels, numFrames);
+				for (uint32 channel = 0; channel < numChannels; ++channel)
+					for (uint32 frame = 0; frame < numFrames; ++frame)
+						EXPECT_EQ(planar[channel][frame], static_cast<float>(frame * numChannels + channel));
+
+				std::vector<float> reinterleaved(numFrames * numChannels);
+				DSP::Interleave(channels.data(), reinterleaved.data(), numChannels, numFrames);
+				EXPECT_EQ(reinterleaved, interleaved);
+			}
+		}
+
+		DSP::ResetInstructionSet();
+	}
+
+	TEST_F(MiniaudioWrappersTest, PlanarLayoutNode)
+	{
+		static_assert(PlanarStereoLayout::IS_PLANAR && !StereoMixLayout::IS_PLANAR);
+		static_assert(StereoMixLayout::INPUT_CHANNEL_OFFSETS[1] == 2);
+		static_assert(std::is_same_v<JPL::TProcessCallbackData<PlanarStereoLayout>::OutputBuffer, choc::buffer::ChannelArrayView<float>>);
+
+		static constexpr uint32 numChannels = 2;
+		static constexpr std::array<float, 2> generatorValues{ 0.25f, -0.5f };
+
+		// Processing size larger than the planar block, to be split into several blocks
+		static constexpr uint32 periodSize = 1024;
+		static_assert(periodSize > PlanarStereoLayout::PLANAR_BLOCK_SIZE);
+
+		MA::Engine engineTest;
+		ASSERT_TRUE(engineTest.Init({ .NumChannels = numChannels, .VFS = &engineVfs, .PeriodSizeInFrames = periodSize, .Offline = true }));
+
+		// generator -> planar gain -> endpoint
+		TBaseNode<node_base_mock<0>> generator;
+		ASSERT_TRUE(generator.Init(NodeLayout().WithOutputs(numChannels).WithEngine(engineTest)));
+		generator->onProcess = [](JPL::ProcessCallbackData& data)
+		{
+			auto output = data.GetOutputBuffer(0);
+			for (uint32 frame = 0; frame < output.getNumFrames(); ++frame)
+				for (uint32 channel = 0; channel < output.getNumChannels(); ++channel)
+					output.getSample(channel, frame) = generatorValues[channel];
+		};
+
+		TBaseNode<planar_gain_mock, PlanarStereoLayout> gainNode;
+		ASSERT_TRUE(gainNode.Init(engineTest));
+		ASSERT_TRUE(generator.OutputBus(0).AttachTo(gainNode.InputBus(0)));
+		ASSERT_TRUE(gainNode.OutputBus(0).AttachTo(engineTest.GetEndpointBus()));
+
+		static constexpr uint64 numFrames = periodSize * 2;
+		std::vector<float> output(numFrames * numChannels);
+		EXPECT_EQ(engineTest.Render(output, numFrames), numFrames);
+
+		EXPECT_EQ(gainNode->MaxBlockSize, PlanarStereoLayout::PLANAR_BLOCK_SIZE);
+
+		for (uint64 frame = 0; frame < numFrames; ++frame)
+		{
+			for (uint32 channel = 0; channel < numChannels; ++channel)
+				EXPECT_FLOAT_EQ(output[frame * numChannels + channel], generatorValues[channel] * planar_gain_mock::Gains[channel]);
+		}
+	}
+
+	TEST_F(MiniaudioWrappersTest, InPlaceNode)
+	{
+		static_assert(TBaseNode<in_place_gain_mock>::IS_IN_PLACE);
+		static_assert(!TBaseNode<node_base_mock<0>>::IS_IN_PLACE);
+
+		static constexpr uint32 numChannels = 2;
+		static constexpr std::array<float, 2> generatorValues{ 0.25f, -0.5f };
+		static constexpr uint32 periodSize = 256;
+
+		MA::Engine engineTest;
+		ASSERT_TRUE(engineTest.Init({ .NumChannels = numChannels, .VFS = &engineVfs, .PeriodSizeInFrames = periodSize, .Offline = true }));
+
+		// Paired busses must have the same number of channels
+		{
+			TBaseNode<in_place_gain_mock> mismatchedNode;
+			EXPECT_FALSE(mismatchedNode.Init(NodeLayout().WithInputs(1).WithOutputs(2).WithEngine(engineTest)));
+		}
+
+		// generator -> in place gain -> in place gain -> endpoint
+		TBaseNode<node_base_mock<0>> generator;
+		ASSERT_TRUE(generator.Init(NodeLayout().WithOutputs(numChannels).WithEngine(engineTest)));
+		generator->onProcess = [](JPL::ProcessCallbackData& data)
+		{
+			auto output = data.GetOutputBuffer(0);
+			for (uint32 frame = 0; frame < output.getNumFrames(); ++frame)
+				for (uint32 channel = 0; channel < output.getNumChannels(); ++channel)
+					output.getSample(channel, frame) = generatorValues[channel];
+		};
+
+		TBaseNode<in_place_gain_mock> gainA, gainB;
+		ASSERT_TRUE(gainA.Init(NodeLayout().WithInputs(numChannels).WithOutputs(numChannels).WithEngine(engineTest)));
+		ASSERT_TRUE(gainB.Init(NodeLayout().WithInputs(numChannels).WithOutputs(numChannels).WithEngine(engineTest)));
+		ASSERT_TRUE(generator.OutputBus(0).AttachTo(gainA.InputBus(0)));
+		ASSERT_TRUE(gainA.OutputBus(0).AttachTo(gainB.InputBus(0)));
+		ASSERT_TRUE(gainB.OutputBus(0).AttachTo(engineTest.GetEndpointBus()));
+
+		static constexpr uint64 numFrames = periodSize * 2;
+		std::vector<float> output(numFrames * numChannels);
+		EXPECT_EQ(engineTest.Render(output, numFrames), numFrames);
+
+		static constexpr float gain = in_place_gain_mock::Gain * in_place_gain_mock::Gain;
+		for (uint64 frame = 0; frame < numFrames; ++frame)
+		{
+			for (uint32 channel = 0; channel < numChannels; ++channel)
+				EXPECT_FLOAT_EQ(output[frame * numChannels + channel], generatorValues[channel] * gain);
+		}
+	}
+
+	TEST_F(MiniaudioWrappersTest, SleepOnSilence)
+	{
+		static_assert(TBaseNode<tail_mock>::SLEEPS_ON_SILENCE);
+		static_assert(!TBaseNode<node_base_mock<0>>::SLEEPS_ON_SILENCE);
+
+		static constexpr uint32 numChannels = 2;
+		static constexpr uint32 periodSize = 256;
+
+		MA::Engine engineTest;
+		ASSERT_TRUE(engineTest.Init({ .NumChannels = numChannels, .VFS = &engineVfs, .PeriodSizeInFrames = periodSize, .Offline = true }));
+
+		// generator -> tail -> endpoint
+		float generatorValue = 0.5f;
+		TBaseNode<node_base_mock<0>> generator;
+		ASSERT_TRUE(generator.Init(NodeLayout().WithOutputs(numChannels).WithEngine(engineTest)));
+		generator->onProcess = [&generatorValue](JPL::ProcessCallbackData& data)
+		{
+			auto output = data.GetOutputBuffer(0);
+			for (uint32 frame = 0; frame < output.getNumFrames(); ++frame)
+				for (uint32 channel = 0; channel < output.getNumChannels(); ++channel)
+					output.getSample(channel, frame) = generatorValue;
+		};
+
+		TBaseNode<tail_mock> tailNode;
+		ASSERT_TRUE(tailNode.Init(NodeLayout().WithInputs(numChannels).WithOutputs(numChannels).WithEngine(engineTest)));
+		ASSERT_TRUE(generator.OutputBus(0).AttachTo(tailNode.InputBus(0)));
+		ASSERT_TRUE(tailNode.OutputBus(0).AttachTo(engineTest.GetEndpointBus()));
+
+		std::vector<float> output(periodSize * numChannels);
+		auto isOutputSilent = [&] { return std::ranges::all_of(output, [](float sample) { return sample == 0.0f; }); };
+
+		// 1. Signal is processed
+		EXPECT_EQ(engineTest.Render(output, periodSize), periodSize);
+		EXPECT_FALSE(tailNode.IsSleeping());
+		EXPECT_GT(tailNode->NumFramesProcessed, 0);
+		EXPECT_FALSE(isOutputSilent());
+
+		// 2. Tail is processed after the input goes silent, then the node goes to sleep
+		generatorValue = 0.0f;
+		const uint64 numFramesBeforeSilence = tailNode->NumFramesProcessed;
+		for (uint32 period = 0; period < 16 && !tailNode.IsSleeping(); ++period)
+			EXPECT_EQ(engineTest.Render(output, periodSize), periodSize);
+
+		ASSERT_TRUE(tailNode.IsSleeping());
+		EXPECT_GE(tailNode->NumFramesProcessed - numFramesBeforeSilence, tail_mock::TailLength);
+
+		// 3. Sleeping node is not processed and outputs silence
+		const uint64 numFramesBeforeSleep = tailNode->NumFramesProcessed;
+		std::ranges::fill(output, 1.0f);
+		EXPECT_EQ(engineTest.Render(output, periodSize), periodSize);
+		EXPECT_TRUE(tailNode.IsSleeping());
+		EXPECT_EQ(tailNode->NumFramesProcessed, numFramesBeforeSleep);
+		EXPECT_TRUE(isOutputSilent());
+
+		// 4. Node wakes up as soon as the input is not silent
+		generatorValue = 0.5f;
+		EXPECT_EQ(engineTest.Render(output, periodSize), periodSize);
+		EXPECT_FALSE(tailNode.IsSleeping());
+		EXPECT_GT(tailNode->NumFramesProcessed, numFramesBeforeSleep);
+		EXPECT_FALSE(isOutputSilent());
+	}
+
+	TEST_F(MiniaudioWrappersTest, FlushDenormals)
+	{
+		if constexpr (!ScopedFlushDenormals::IsSupported())
+			return;
+
+		// Threads don't flush denormals by default
+		ASSERT_FALSE(ScopedFlushDenormals::IsEnabled());
+
+		volatile float denormal = std::numeric_limits<float>::denorm_min();
+		{
+			ScopedFlushDenormals flushDenormals;
+			EXPECT_TRUE(ScopedFlushDenormals::IsEnabled());
+			EXPECT_EQ(denormal * 1.0f, 0.0f);
+
+			// Nested scopes don't change the mode of the outer scope
+			{
+				ScopedFlushDenormals nested;
+				ScopedFlushDenormals disabled(false);
+				EXPECT_TRUE(ScopedFlushDenormals::IsEnabled());
+			}
+			EXPECT_TRUE(ScopedFlushDenormals::IsEnabled());
+		}
+
+		// Previous mode is restored
+		EXPECT_FALSE(ScopedFlushDenormals::IsEnabled());
+		EXPECT_NE(denormal * 1.0f, 0.0f);
+
+		static_assert(TBaseNode<node_base_mock<0>>::FLUSHES_DENORMALS);
+		static_assert(!TBaseNode<denormals_probe_mock>::FLUSHES_DENORMALS);
+
+		for (const bool bFlushDenormals : { true, false })
+		{
+			SCOPED_TRACE(bFlushDenormals ? "Engine flushes denormals" : "Engine keeps denormals");
+
+			MA::Engine engineTest;
+			ASSERT_TRUE(engineTest.Init({ .NumChannels = 2, .VFS = &engineVfs, .Offline = true, .FlushDenormals = bFlushDenormals }));
+
+			// Processed in the engine's mode
+			TBaseNode<denormals_probe_mock> probe;
+			ASSERT_TRUE(probe.Init(NodeLayout().WithOutputs(2).WithEngine(engineTest)));
+			ASSERT_TRUE(probe.OutputBus(0).AttachTo(engineTest.GetEndpointBus()));
+
+			// Flushes denormals regardless of the engine
+			bool bNodeWasFlushing = false;
+			TBaseNode<node_base_mock<0>> node;
+			ASSERT_TRUE(node.Init(NodeLayout().WithOutputs(2).WithEngine(engineTest)));
+			ASSERT_TRUE(node.OutputBus(0).AttachTo(engineTest.GetEndpointBus()));
+			node->onProcess = [&bNodeWasFlushing](JPL::ProcessCallbackData& data)
+			{
+				bNodeWasFlushing = ScopedFlushDenormals::IsEnabled();
+				data.FillOutputWithSilence();
+			};
+
+			std::vector<float> output(256 * 2);
+			EXPECT_EQ(engineTest.Render(output, 256), 256);
+
+			EXPECT_EQ(probe->bWasFlushing, bFlushDenormals);
+			EXPECT_TRUE(bNodeWasFlushing);
+			EXPECT_FALSE(ScopedFlushDenormals::IsEnabled());
+		}
+	}
+
+	TEST_F(MiniaudioWrappersTest, VariableRateNode)
+	{
+		static_assert(TBaseNode<decimator_mock>::HAS_REQUIRED_INPUT_FRAME_COUNT);
+		static_assert(!TBaseNode<node_base_mock<0>>::HAS_REQUIRED_INPUT_FRAME_COUNT);
+
+		static constexpr uint32 numChannels = 2;
+		static constexpr uint32 periodSize = 256;
+
+		MA::Engine engineTest;
+		ASSERT_TRUE(engineTest.Init({ .NumChannels = numChannels, .VFS = &engineVfs, .PeriodSizeInFrames = periodSize, .Offline = true }));
+
+		// generator (ramp) -> decimator -> endpoint
+		TBaseNode<node_base_mock<0>> generator;
+		ASSERT_TRUE(generator.Init(NodeLayout().WithOutputs(numChannels).WithEngine(engineTest)));
+
+		uint64 numFramesGenerated = 0;
+		generator->onProcess = [&numFramesGenerated](JPL::ProcessCallbackData& data)
+		{
+			auto output = data.GetOutputBuffer(0);
+			for (uint32 frame = 0; frame < output.getNumFrames(); ++frame, ++numFramesGenerated)
+				for (uint32 channel = 0; channel < output.getNumChannels(); ++channel)
+					output.getSample(channel, frame) = static_cast<float>(numFramesGenerated) * 1e-4f;
+		};
+
+		TBaseNode<decimator_mock> decimator;
+		ASSERT_TRUE(decimator.Init(NodeLayout().WithInputs(numChannels).WithOutputs(numChannels).WithEngine(engineTest)));
+		ASSERT_TRUE(generator.OutputBus(0).AttachTo(decimator.InputBus(0)));
+		ASSERT_TRUE(decimator.OutputBus(0).AttachTo(engineTest.GetEndpointBus()));
+
+		static constexpr uint64 numFrames = periodSize * 4;
+		std::vector<float> output(numFrames * numChannels);
+		EXPECT_EQ(engineTest.Render(output, numFrames), numFrames);
+
+		// Every frame is pulled from the generator once, unconsumed frames are kept for the next call
+		EXPECT_GE(numFramesGenerated, numFrames * decimator_mock::Factor);
+
+		for (uint64 frame = 0; frame < numFrames; ++frame)
+		{
+			for (uint32 channel = 0; channel < numChannels; ++channel)
+				EXPECT_FLOAT_EQ(output[frame * numChannels + channel], static_cast<float>(frame * decimator_mock::Factor) * 1e-4f);
+		}
+	}
+
+	TEST_F(MiniaudioWrappersTest, AtomicHistogram)
+	{
+		AtomicHistogram<10> linear(AtomicHistogram<10>::EScale::Linear, 0.0, 100.0);
+		EXPECT_EQ(linear.GetTotalCount(), 0);
+		EXPECT_DOUBLE_EQ(linear.GetPercentile(0.5), 0.0);
+
+		linear.Add(-5.0);	// clamped to the first bin
+		linear.Add(5.0);
+		linear.Add(15.0);
+		linear.Add(95.0);
+		linear.Add(500.0);	// clamped to the last bin
+		EXPECT_EQ(linear.GetTotalCount(), 5);
+		EXPECT_EQ(linear.GetBinCount(0), 2);
+		EXPECT_EQ(linear.GetBinCount(1), 1);
+		EXPECT_EQ(linear.GetBinCount(9), 2);
+		EXPECT_DOUBLE_EQ(linear.GetBinLowerBound(1), 10.0);
+		EXPECT_DOUBLE_EQ(linear.GetPercentile(0.4), 10.0);
+		EXPECT_DOUBLE_EQ(linear.GetPercentile(0.6), 20.0);
+		EXPECT_DOUBLE_EQ(linear.GetPercentile(1.0), 100.0);
+
+		AtomicHistogram<16> log2(AtomicHistogram<16>::EScale::Log2, 1.0, 16.0);
+		log2.Add(1.0);
+		log2.Add(2.5);
+		log2.Add(8.0);
+		EXPECT_EQ(log2.GetBinCount(0), 1);
+		EXPECT_EQ(log2.GetBinCount(5), 1); // log2(2.5) * 4 = 5.29
+		EXPECT_EQ(log2.GetBinCount(12), 1);
+		EXPECT_DOUBLE_EQ(log2.GetBinLowerBound(4), 2.0);
+
+		linear.Reset();
+		EXPECT_EQ(linear.GetTotalCount(), 0);
+	}
+
+	TEST_F(MiniaudioWrappersTest, EngineProfiler)
+	{
+		static constexpr uint32 numChannels = 2;
+		static constexpr uint32 periodSize = 128;
+		static constexpr uint32 numBlocks = 20;
+
+		MA::Engine engineNoProfiling;
+		ASSERT_TRUE(engineNoProfiling.Init({ .NumChannels = numChannels, .VFS = &engineVfs, .Offline = true }));
+		EXPECT_EQ(engineNoProfiling.GetProfiler(), nullptr);
+
+		MA::Engine engineTest;
+		ASSERT_TRUE(engineTest.Init({ .NumChannels = numChannels, .VFS = &engineVfs, .PeriodSizeInFrames = periodSize, .Offline = true, .EnableProfiling = true }));
+
+		CallbackProfiler* profiler = engineTest.GetProfiler();
+		ASSERT_NE(profiler, nullptr);
+		EXPECT_EQ(profiler->GetSnapshot().NumCallbacks, 0);
+
+		std::vector<float> output(periodSize * numChannels);
+		for (uint32 i = 0; i < numBlocks; ++i)
+			EXPECT_EQ(engineTest.Render(output, periodSize), periodSize);
+
+		const CallbackProfiler::Snapshot snapshot = profiler->GetSnapshot();
+		EXPECT_EQ(snapshot.NumCallbacks, numBlocks);
+		EXPECT_GE(snapshot.PeakLoadPercent, snapshot.LastLoadPercent);
+		EXPECT_GE(snapshot.PeakLoadPercent, snapshot.AverageLoadPercent);
+		EXPECT_LE(snapshot.NumDeadlineMisses, numBlocks);
+		EXPECT_EQ(profiler->GetProcessingTimeHistogram().GetTotalCount(), numBlocks);
+		EXPECT_EQ(profiler->GetLoadHistogram().GetTotalCount(), numBlocks);
+		// No jitter for the first callback
+		EXPECT_EQ(profiler->GetJitterHistogram().GetTotalCount(), numBlocks - 1);
+
+		// Reset is applied by the next callback
+		profiler->Reset();
+		EXPECT_EQ(profiler->GetSnapshot().NumCallbacks, numBlocks);
+		EXPECT_EQ(engineTest.Render(output, periodSize), periodSize);
+		EXPECT_EQ(profiler->GetSnapshot().NumCallbacks, 1);
+		EXPECT_EQ(profiler->GetProcessingTimeHistogram().GetTotalCount(), 1);
+	}
+
+	TEST_F(MiniaudioWrappersTest, NodeProfiler)
+	{
+		static constexpr uint32 numChannels = 2;
+		static constexpr uint32 periodSize = 64;
+		static constexpr uint32 numBlocks = 10;
+
+		MA::Engine engineTest;
+		ASSERT_TRUE(engineTest.Init({ .NumChannels = numChannels, .VFS = &engineVfs, .PeriodSizeInFrames = periodSize, .Offline = true }));
+
+		const uint32 numRegisteredBefore = NodeProfiler::GetNumRegisteredNodes();
+		{
+			static constexpr int ZERO_FLAGS = 0;
+			TBaseNode<node_base_mock<ZERO_FLAGS>> node;
+			ASSERT_TRUE(node.Init(NodeLayout().WithOutputs(numChannels).WithEngine(engineTest)));
+			node->onProcess = [](JPL::ProcessCallbackData& data) { data.FillOutputWithSilence(); };
+			ASSERT_TRUE(node.OutputBus(0).AttachTo(engineTest.GetEndpointBus()));
+
+			std::vector<float> output(periodSize * numChannels);
+			for (uint32 i = 0; i < numBlocks; ++i)
+				EXPECT_EQ(engineTest.Render(output, periodSize), periodSize);
+
+#if defined(JPL_ENABLE_NODE_PROFILING)
+			EXPECT_EQ(NodeProfiler::GetNumRegisteredNodes(), numRegisteredBefore + 1);
+
+			const std::vector<NodeProfiler::NodeReport> reports = NodeProfiler::GetTopNodes(numRegisteredBefore + 1);
+			auto report = std::ranges::find(reports, static_cast<const void*>(node.get()), &NodeProfiler::NodeReport::Node);
+			ASSERT_NE(report, reports.end());
+			EXPECT_EQ(report->NumCalls, numBlocks);
+			EXPECT_GE(report->TotalNs, report->PeakNs);
+			EXPECT_NE(report->Name.find("node_base_mock"), std::string_view::npos);
+
+			EXPECT_NE(NodeProfiler::FormatTopNodes(1).find("node_base_mock"), std::string::npos);
+
+			NodeProfiler::ResetAll();
+			EXPECT_EQ(NodeProfiler::GetTopNodes(numRegisteredBefore + 1).front().TotalNs, 0);
+#else
+			// Nothing is registered if profiling is not compiled in
+			EXPECT_EQ(NodeProfiler::GetNumRegisteredNodes(), numRegisteredBefore);
+#endif
+		}
+		EXPECT_EQ(NodeProfiler::GetNumRegisteredNodes(), numRegisteredBefore);
+	}
+
+	TEST_F(MiniaudioWrappersTest, CommandQueue)
+	{
+		CommandQueue queue(10);
+		EXPECT_EQ(queue.GetCapacity(), 16);
+		EXPECT_EQ(queue.ConsumeAll([](const ParameterCommand&) {}), 0);
+
+		// Batch is pushed either whole or not at all
+		std::vector<ParameterCommand> batch(10, ParameterCommand{ .Type = ParameterCommand::EType::SoundVolume });
+		EXPECT_TRUE(queue.Push(batch));
+		EXPECT_FALSE(queue.Push(batch));
+		EXPECT_EQ(queue.ConsumeAll([](const ParameterCommand&) {}), 10);
+		EXPECT_TRUE(queue.Push(batch));
+		EXPECT_EQ(queue.ConsumeAll([](const ParameterCommand&) {}), 10);
+
+		// Multiple producers, batches must come out contiguous and in the order of each producer
+		static constexpr uint32 numProducers = 4;
+		static constexpr uint32 numBatches = 1000;
+		static constexpr uint32 batchSize = 3;
+
+		std::atomic<uint32> numProducersDone = 0;
+		std::vector<std::jthread> producers;
+		for (uint32 producer = 0; producer < numProducers; ++producer)
+		{
+			producers.emplace_back([&queue, &numProducersDone, producer]
+			{
+				for (uint32 batchIndex = 0; batchIndex < numBatches;)
+				{
+					std::array<ParameterCommand, batchSize> commands;
+					for (uint32 i = 0; i < batchSize; ++i)
+						commands[i] = { ParameterCommand::EType::SoundVolume, i, nullptr, producer * numBatches + static_cast<double>(batchIndex) };
+
+					if (queue.Push(commands))
+						++batchIndex;
+					else
+						std::this_thread::yield();
+				}
+				++numProducersDone;
+			});
+		}
+
+		std::array<double, numProducers> nextValue;
+		for (uint32 producer = 0; producer < numProducers; ++producer)
+			nextValue[producer] = producer * numBatches;
+
+		uint32 numConsumed = 0;
+		uint32 expectedIndex = 0;
+		double batchValue = 0.0;
+		bool bValid = true;
+		const auto consume = [&](const ParameterCommand& command)
+		{
+			bValid &= command.Index == expectedIndex;
+			if (expectedIndex == 0)
+			{
+				batchValue = command.Value;
+				const uint32 producer = static_cast<uint32>(command.Value) / numBatches;
+				bValid &= nextValue[producer] == command.Value;
+				nextValue[producer] += 1.0;
+			}
+			bValid &= command.Value == batchValue;
+
+			expectedIndex = (expectedIndex + 1) % batchSize;
+			++numConsumed;
+		};
+
+		while (numProducersDone < numProducers)
+			queue.ConsumeAll(consume);
+		queue.ConsumeAll(consume);
+
+		EXPECT_TRUE(bValid);
+		EXPECT_EQ(numConsumed, numProducers * numBatches * batchSize);
+	}
+
+	TEST_F(MiniaudioWrappersTest, EngineSubmitCommands)
+	{
+		static constexpr uint32 numChannels = 2;
+		static constexpr uint64 numFrames = 64;
+
+		MA::Engine engineNoQueue;
+		ASSERT_TRUE(engineNoQueue.Init({ .NumChannels = numChannels, .VFS = &engineVfs, .Offline = true, .CommandQueueCapacity = 0 }));
+
+		MA::Engine engineTest;
+		ASSERT_TRUE(engineTest.Init({ .NumChannels = numChannels, .VFS = &engineVfs, .Offline = true, .CommandQueueCapacity = 8 }));
+
+		MA::Sound sound;
+		ASSERT_TRUE(sound.Init(engineTest, "Some filepath", 0));
+
+		MA::LPFNode lpf;
+		ASSERT_TRUE(lpf.Init(engineTest, numChannels, 1'000.0, 2));
+
+		const float initialVolume = sound.GetVolume();
+		const float initialPitch = sound.GetPitch();
+		const float initialBusVolume = lpf.OutputBus(0).GetVolume();
+
+		CommandBatch batch;
+		batch.SetVolume(sound, 0.5f);
+		batch.SetPitch(sound, 2.0f);
+		batch.SetVolume(lpf.OutputBus(0), 0.25f);
+		batch.SetCutoffFrequency(lpf, 500.0);
+		EXPECT_EQ(batch.GetNumCommands(), 4);
+
+		// Wrapper's cached cutoff is updated immediately
+		EXPECT_DOUBLE_EQ(lpf.GetCutoffFrequency(), 500.0);
+
+		EXPECT_FALSE(engineNoQueue.Submit(batch));
+		EXPECT_EQ(batch.GetNumCommands(), 4);
+
+		ASSERT_TRUE(engineTest.Submit(batch));
+		EXPECT_TRUE(batch.IsEmpty());
+
+		// Nothing is applied until the next audio block
+		EXPECT_FLOAT_EQ(sound.GetVolume(), initialVolume);
+		EXPECT_FLOAT_EQ(sound.GetPitch(), initialPitch);
+		EXPECT_FLOAT_EQ(lpf.OutputBus(0).GetVolume(), initialBusVolume);
+
+		std::vector<float> output(numFrames * numChannels);
+		EXPECT_EQ(engineTest.Render(output, numFrames), numFrames);
+
+		EXPECT_FLOAT_EQ(sound.GetVolume(), 0.5f);
+		EXPECT_FLOAT_EQ(sound.GetPitch(), 2.0f);
+		EXPECT_FLOAT_EQ(lpf.OutputBus(0).GetVolume(), 0.25f);
+
+		// Batch that doesn't fit is rejected whole
+		for (uint32 i = 0; i < 9; ++i)
+			batch.SetVolume(sound, 1.0f);
+		EXPECT_FALSE(engineTest.Submit(batch));
+		EXPECT_EQ(batch.GetNumCommands(), 9);
+	}
+
+	TEST_F(MiniaudioWrappersTest, RealtimeLog)
+	{
+		RealtimeLog log(4);
+		EXPECT_EQ(log.GetCapacity(), 4);
+		EXPECT_EQ(log.Drain([](const RealtimeLog::Record&) {}), 0);
+
+		// New lines and braces are stripped, long messages are truncated
+		EXPECT_TRUE(log.Push(MA_LOG_LEVEL_WARNING, "{Device} stopped\n"));
+		const std::string longMessage(RealtimeLog::cMaxMessageLength * 2, 'a');
+		EXPECT_TRUE(log.Push(MA_LOG_LEVEL_ERROR, longMessage.c_str()));
+
+		std::vector<std::pair<uint32, std::string>> messages;
+		const auto collect = [&messages](const RealtimeLog::Record& record) { messages.emplace_back(record.Level, record.GetMessage()); };
+
+		EXPECT_EQ(log.Drain(collect), 2);
+		ASSERT_EQ(messages.size(), 2);
+		EXPECT_EQ(messages[0].first, MA_LOG_LEVEL_WARNING);
+		EXPECT_EQ(messages[0].second, "Device stopped");
+		EXPECT_EQ(messages[1].first, MA_LOG_LEVEL_ERROR);
+		EXPECT_EQ(messages[1].second.size(), RealtimeLog::cMaxMessageLength);
+
+		// Messages are dropped when the ring is full
+		for (uint32 i = 0; i < log.GetCapacity(); ++i)
+			EXPECT_TRUE(log.Push(MA_LOG_LEVEL_INFO, std::to_string(i).c_str()));
+		EXPECT_FALSE(log.Push(MA_LOG_LEVEL_INFO, "dropped"));
+		EXPECT_EQ(log.GetNumDropped(), 1);
+
+		messages.clear();
+		EXPECT_EQ(log.Drain(collect), log.GetCapacity());
+		for (uint32 i = 0; i < messages.size(); ++i)
+			EXPECT_EQ(messages[i].second, std::to_string(i));
+
+		// Multiple producers
+		static constexpr uint32 numProducers = 4;
+		static constexpr uint32 numMessages = 500;
+
+		std::atomic<uint32> numProducersDone = 0;
+		std::atomic<uint32> numPushed = 0;
+		{
+			std::vector<std::jthread> producers;
+			for (uint32 producer = 0; producer < numProducers; ++producer)
+			{
+				producers.emplace_back([&, producer]
+				{
+					for (uint32 i = 0; i < numMessages; ++i)
+						numPushed += log.Push(producer, std::to_string(i).c_str()) ? 1 : 0;
+					++numProducersDone;
+				});
+			}
+
+			// Messages of each producer must come out in order
+			std::array<int, numProducers> lastMessage;
+			lastMessage.fill(-1);
+			bool bOrdered = true;
+			uint32 numDrained = 0;
+			const auto check = [&](const RealtimeLog::Record& record)
+			{
+				const int message = std::stoi(std::string(record.GetMessage()));
+				bOrdered &= message > lastMessage[record.Level];
+				lastMessage[record.Level] = message;
+				++numDrained;
+			};
+
+			while (numProducersDone < numProducers)
+				log.Drain(check);
+			log.Drain(check);
+
+			EXPECT_TRUE(bOrdered);
+			EXPECT_EQ(numDrained, numPushed);
+		}
+		EXPECT_EQ(numPushed + log.GetNumDropped(), numProducers * numMessages + 1);
+	}
+
+	TEST_F(MiniaudioWrappersTest, PoolAllocator)
+	{
+		{
+			JPL::PoolAllocator allocator;
+			EXPECT_FALSE(allocator.IsArena());
+
+			void* small = allocator.Allocate(24, EAllocationCategory::Nodes);
+			ASSERT_NE(small, nullptr);
+			EXPECT_EQ(reinterpret_cast<uintptr_t>(small) % alignof(std::max_align_t), 0);
+
+			static constexpr size_t largeSize = JPL::PoolAllocator::cMaxBlockSize * 2;
+			void* large = allocator.Allocate(largeSize, EAllocationCategory::Other);
+			ASSERT_NE(large, nullptr);
+
+			EXPECT_EQ(allocator.GetStats(EAllocationCategory::Nodes).CurrentBytes, 24);
+			EXPECT_EQ(allocator.GetStats(EAllocationCategory::Other).CurrentBytes, largeSize);
+			EXPECT_EQ(allocator.GetLargeAllocatedBytes(), largeSize);
+			EXPECT_EQ(allocator.GetTotalAllocatedBytes(), 24 + largeSize);
+			EXPECT_GT(allocator.GetReservedBytes(), 0);
+
+			// Reallocation preserves the contents
+			std::memset(small, 0xab, 24);
+			void* grown = allocator.Reallocate(small, 1000, EAllocationCategory::Nodes);
+			ASSERT_NE(grown, nullptr);
+			EXPECT_TRUE(std::all_of(static_cast<uint8*>(grown), static_cast<uint8*>(grown) + 24, [](uint8 byte) { return byte == 0xab; }));
+			EXPECT_EQ(allocator.GetStats(EAllocationCategory::Nodes).CurrentBytes, 1000);
+
+			allocator.Free(grown);
+			allocator.Free(large);
+
+			const JPL::PoolAllocator::CategoryStats stats = allocator.GetStats(EAllocationCategory::Nodes);
+			EXPECT_EQ(stats.CurrentBytes, 0);
+			EXPECT_EQ(stats.PeakBytes, 1000);
+			EXPECT_EQ(stats.NumAllocations, stats.NumFrees);
+			EXPECT_EQ(allocator.GetLargeAllocatedBytes(), 0);
+
+			// Freed blocks are reused
+			void* first = allocator.Allocate(24, EAllocationCategory::Nodes);
+			allocator.Free(first);
+			void* second = allocator.Allocate(24, EAllocationCategory::Nodes);
+			EXPECT_EQ(first, second);
+			allocator.Free(second);
+
+			// Churn from multiple threads through the callbacks
+			{
+				ma_allocation_callbacks* callbacks = allocator.GetCallbacks(EAllocationCategory::Nodes);
+				std::vector<std::jthread> threads;
+				for (uint32 t = 0; t < 4; ++t)
+				{
+					threads.emplace_back([callbacks, t]
+					{
+						std::vector<void*> allocations;
+						for (uint32 i = 0; i < 1000; ++i)
+						{
+							allocations.push_back(callbacks->onMalloc((i * 37 + t) % 20'000, callbacks->pUserData));
+							if (allocations.size() > 16)
+							{
+								callbacks->onFree(allocations.front(), callbacks->pUserData);
+								allocations.erase(allocations.begin());
+							}
+						}
+						for (void* allocation : allocations)
+							callbacks->onFree(allocation, callbacks->pUserData);
+					});
+				}
+			}
+			EXPECT_EQ(allocator.GetTotalAllocatedBytes(), 0);
+
+			// Engine and everything it owns is allocated with the allocator
+			{
+				MA::Engine engine;
+				ASSERT_TRUE(engine.Init({
+					.NumChannels = 2,
+					.VFS = &engineVfs,
+					.AllocationCallbacks = allocator.GetCallbacks(EAllocationCategory::Engine),
+					.Offline = true
+				}));
+				EXPECT_GT(allocator.GetStats(EAllocationCategory::Engine).CurrentBytes, 0);
+			}
+			EXPECT_EQ(allocator.GetStats(EAllocationCategory::Engine).CurrentBytes, 0);
+		}
+
+		// Arena doesn't grow
+		{
+			JPL::PoolAllocator arena({ .ArenaSizeInBytes = 4096 });
+			EXPECT_TRUE(arena.IsArena());
+			EXPECT_EQ(arena.GetReservedBytes(), 4096);
+
+			// 100 bytes + header fit into 128 byte blocks
+			std::vector<void*> allocations;
+			while (void* allocation = arena.Allocate(100, EAllocationCategory::Other))
+				allocations.push_back(allocation);
+
+			EXPECT_EQ(allocations.size(), 4096 / 128);
+			EXPECT_EQ(arena.GetStats(EAllocationCategory::Other).NumFailed, 1);
+			EXPECT_EQ(arena.GetReservedBytes(), 4096);
+
+			for (void* allocation : allocations)
+				arena.Free(allocation);
+
+			void* allocation = arena.Allocate(100, EAllocationCategory::Other);
+			EXPECT_NE(allocation, nullptr);
+			arena.Free(allocation);
+		}
+	}
+
+	TEST_F(MiniaudioWrappersTest, SlabAllocation)
+	{
+		// Pool reuses freed objects and keeps consecutive allocations adjacent
+		{
+			struct Object { uint64 Value = 42; };
+			Internal::SlabPool<Object, 4> pool;
+
+			std::array<Object*, 5> objects;
+			for (Object*& object : objects)
+				object = pool.Allocate();
+
+			EXPECT_EQ(objects[0]->Value, 42);
+			EXPECT_EQ(reinterpret_cast<std::byte*>(objects[1]) - reinterpret_cast<std::byte*>(objects[0]), sizeof(Object));
+			EXPECT_EQ(pool.GetNumAllocated(), 5);
+			EXPECT_EQ(pool.GetCapacity(), 8);
+
+			Object* freed = objects[2];
+			pool.Deallocate(freed);
+			EXPECT_EQ(pool.Allocate(), freed);
+			EXPECT_EQ(pool.GetCapacity(), 8);
+
+			for (Object* object : objects)
+				pool.Deallocate(object);
+			EXPECT_EQ(pool.GetNumAllocated(), 0);
+		}
+
+		// Nodes are allocated from the pool of their type, and returned on destruction
+		{
+			auto& lpfPool = Internal::SlabPool<ma_lpf_node>::Get();
+			const uint32 numAllocated = lpfPool.GetNumAllocated();
+			{
+				std::array<MA::LPFNode, 3> filters;
+				for (MA::LPFNode& filter : filters)
+					ASSERT_TRUE(filter.Init(engine, 2, 1'000.0, 1));
+
+				EXPECT_EQ(lpfPool.GetNumAllocated(), numAllocated + 3);
+			}
+			EXPECT_EQ(lpfPool.GetNumAllocated(), numAllocated);
+
+			auto& soundPool = Internal::SlabPool<ma_sound>::Get();
+			const uint32 numSounds = soundPool.GetNumAllocated();
+			{
+				MA::Sound sound;
+				ASSERT_TRUE(sound.Init(engine, "Some filepath", 0));
+				EXPECT_EQ(soundPool.GetNumAllocated(), numSounds + 1);
+
+				// Reinitializing reuses the slot
+				ma_sound* previous = sound.get();
+				ASSERT_TRUE(sound.Init(engine, "Some filepath", 0));
+				EXPECT_EQ(sound.get(), previous);
+				EXPECT_EQ(soundPool.GetNumAllocated(), numSounds + 1);
+			}
+			EXPECT_EQ(soundPool.GetNumAllocated(), numSounds);
+		}
+	}
+
+	TEST_F(MiniaudioWrappersTest, VoiceManager)
+	{
+		MA::Engine engineTest;
+		ASSERT_TRUE(engineTest.Init({ .NumChannels = 2, .VFS = &engineVfs, .Offline = true }));
+
+		std::array<MA::Sound, 5> sounds;
+		for (MA::Sound& sound : sounds)
+		{
+			ASSERT_TRUE(sound.Init(engineTest, "Some filepath", 0));
+			sound.SetLooping(true);
+		}
+
+		JPL::VoiceManager voices;
+		ASSERT_TRUE(voices.Init(engineTest, { .MaxVoices = 2, .MaxReleasingVoices = 1, .StealFadeInMilliseconds = 10 }));
+
+		EXPECT_TRUE(voices.Play(sounds[0], { .Priority = 0 }));
+		EXPECT_TRUE(voices.Play(sounds[1], { .Priority = 5 }));
+		EXPECT_EQ(voices.GetNumActiveVoices(), 2);
+
+		// Lowest priority voice is stolen and faded out
+		EXPECT_TRUE(voices.Play(sounds[2], { .Priority = 1 }));
+		EXPECT_EQ(voices.GetNumActiveVoices(), 2);
+		EXPECT_EQ(voices.GetNumReleasingVoices(), 1);
+		EXPECT_EQ(voices.GetNumStolen(), 1);
+		EXPECT_TRUE(voices.IsTracked(sounds[0]));
+		EXPECT_TRUE(sounds[0].IsPlaying());
+
+		// Voices of higher priority are not stolen
+		EXPECT_FALSE(voices.Play(sounds[3], { .Priority = -1 }));
+		EXPECT_FALSE(sounds[3].IsPlaying());
+		EXPECT_EQ(voices.GetNumRejected(), 1);
+
+		// Only one voice can be fading out, the next stolen voice is stopped immediately
+		EXPECT_TRUE(voices.Play(sounds[3], { .Priority = 2 }));
+		EXPECT_FALSE(sounds[2].IsPlaying());
+		EXPECT_FALSE(voices.IsTracked(sounds[2]));
+		EXPECT_EQ(voices.GetNumReleasingVoices(), 1);
+		EXPECT_EQ(voices.GetNumStolen(), 2);
+
+		// Faded out voice is stopped by the engine and released on update
+		std::vector<float> output(engineTest.GetSampleRate() / 10 * engineTest.GetNumChannels());
+		engineTest.Render(output, engineTest.GetSampleRate() / 10);
+		voices.Update();
+		EXPECT_EQ(voices.GetNumReleasingVoices(), 0);
+		EXPECT_FALSE(sounds[0].IsPlaying());
+		EXPECT_FALSE(voices.IsTracked(sounds[0]));
+
+		// Between voices of the same priority, the quietest one is stolen
+		voices.Stop(sounds[1]);
+		voices.Stop(sounds[3]);
+		EXPECT_EQ(voices.GetNumActiveVoices(), 0);
+
+		sounds[0].SetVolume(1.0f);
+		sounds[1].SetVolume(0.25f);
+		EXPECT_TRUE(voices.Play(sounds[0]));
+		EXPECT_TRUE(voices.Play(sounds[1]));
+		EXPECT_TRUE(voices.Play(sounds[2]));
+		EXPECT_EQ(voices.GetNumActiveVoices(), 2);
+		EXPECT_EQ(voices.GetNumReleasingVoices(), 1);
+
+		engineTest.Render(output, engineTest.GetSampleRate() / 10);
+		voices.Update();
+		EXPECT_TRUE(sounds[0].IsPlaying());
+		EXPECT_FALSE(sounds[1].IsPlaying());
+
+		// Category limit steals within the category
+		voices.Stop(sounds[0]);
+		voices.Stop(sounds[1]);
+		voices.Stop(sounds[2]);
+
+		static constexpr uint32 footsteps = 7;
+		voices.SetCategoryLimit(footsteps, 1);
+		EXPECT_EQ(voices.GetCategoryLimit(footsteps), 1);
+
+		EXPECT_TRUE(voices.Play(sounds[0], { .Priority = 0 }));
+		EXPECT_TRUE(voices.Play(sounds[3], { .Priority = 10, .Category = footsteps }));
+		EXPECT_TRUE(voices.Play(sounds[4], { .Priority = 10, .Category = footsteps }));
+		EXPECT_EQ(voices.GetNumVoices(footsteps), 1);
+		EXPECT_TRUE(voices.IsTracked(sounds[0]));
+		EXPECT_TRUE(sounds[0].IsPlaying());
+		EXPECT_EQ(voices.GetNumActiveVoices(), 2);
+
+		// Sounds must not be tracked when destroyed
+		for (MA::Sound& sound : sounds)
+			voices.Remove(sound);
+		EXPECT_EQ(voices.GetNumActiveVoices(), 0);
+		EXPECT_EQ(voices.GetNumReleasingVoices(), 0);
+	}
+
+	TEST_F(MiniaudioWrappersTest, VirtualVoices)
+	{
+		static constexpr uint32 sampleRate = WaveformMockReader::sourceSampleRate;
+
+		MA::Engine engineTest;
+		ASSERT_TRUE(engineTest.Init({ .NumChannels = 2, .SampleRate = sampleRate, .VFS = &engineVfs, .Offline = true }));
+
+		const uint32 numFrames = sampleRate / 10;
+		std::vector<float> output(numFrames * engineTest.GetNumChannels());
+
+		// Virtual sound keeps its timeline without being processed
+		{
+			MA::Sound sound;
+			ASSERT_TRUE(sound.Init(engineTest, "Some filepath", 0));
+			sound.SetLooping(true);
+
+			EXPECT_FALSE(sound.Virtualize());
+			ASSERT_TRUE(sound.Start());
+			ASSERT_TRUE(sound.Virtualize());
+			EXPECT_TRUE(sound.IsVirtual());
+			EXPECT_FALSE(sound.IsPlaying());
+			EXPECT_EQ(sound.GetVirtualCursorInFrames(), 0);
+
+			engineTest.Render(output, numFrames);
+			EXPECT_EQ(sound.GetCursorInFrames(), 0);
+			EXPECT_EQ(sound.GetVirtualCursorInFrames(), numFrames);
+
+			ASSERT_TRUE(sound.Devirtualize());
+			EXPECT_FALSE(sound.IsVirtual());
+			EXPECT_TRUE(sound.IsPlaying());
+			EXPECT_EQ(sound.GetCursorInFrames(), numFrames);
+			EXPECT_FALSE(sound.Devirtualize());
+
+			// Looping sound wraps around
+			ASSERT_TRUE(sound.SeekToFrame(WaveformMockReader::durationInFrames - numFrames / 2));
+			ASSERT_TRUE(sound.Virtualize());
+			engineTest.Render(output, numFrames);
+			EXPECT_EQ(sound.GetVirtualCursorInFrames(), numFrames / 2);
+
+			// Non-looping sound finishes while virtual
+			sound.SetLooping(false);
+			engineTest.Render(output, numFrames);
+			ASSERT_TRUE(sound.Devirtualize());
+			EXPECT_FALSE(sound.IsPlaying());
+			EXPECT_TRUE(sound.IsAtEnd());
+		}
+
+		// Virtual state moves with the sound
+		{
+			MA::Sound sound;
+			ASSERT_TRUE(sound.Init(engineTest, "Some filepath", 0));
+			ASSERT_TRUE(sound.Start());
+			ASSERT_TRUE(sound.Virtualize());
+
+			MA::Sound moved(std::move(sound));
+			EXPECT_TRUE(moved.IsVirtual());
+			EXPECT_FALSE(sound.IsVirtual());
+
+			sound = std::move(moved);
+			EXPECT_TRUE(sound.IsVirtual());
+			EXPECT_FALSE(moved.IsVirtual());
+		}
+
+		// Voice manager virtualizes inaudible voices, they don't take up the limit
+		{
+			std::array<MA::Sound, 3> sounds;
+			for (MA::Sound& sound : sounds)
+			{
+				ASSERT_TRUE(sound.Init(engineTest, "Some filepath", 0));
+				sound.SetLooping(true);
+			}
+
+			JPL::VoiceManager voices;
+			ASSERT_TRUE(voices.Init(engineTest, { .MaxVoices = 2, .StealFadeInMilliseconds = 0 }));
+
+			sounds[0].SetVolume(0.0f);
+			EXPECT_TRUE(voices.Play(sounds[0], { .Priority = 10 }));
+			EXPECT_TRUE(sounds[0].IsVirtual());
+			EXPECT_EQ(voices.GetNumVirtualVoices(), 1);
+			EXPECT_EQ(voices.GetNumActiveVoices(), 0);
+
+			EXPECT_TRUE(voices.Play(sounds[1], { .Priority = 0 }));
+			EXPECT_TRUE(voices.Play(sounds[2], { .Priority = 0 }));
+			EXPECT_EQ(voices.GetNumActiveVoices(), 2);
+			EXPECT_EQ(voices.GetNumStolen(), 0);
+
+			// Becomes audible, comes back stealing a voice of lower priority
+			sounds[0].SetVolume(1.0f);
+			engineTest.Render(output, numFrames);
+			voices.Update();
+			EXPECT_FALSE(sounds[0].IsVirtual());
+			EXPECT_TRUE(sounds[0].IsPlaying());
+			EXPECT_EQ(sounds[0].GetCursorInFrames(), numFrames);
+			EXPECT_EQ(voices.GetNumActiveVoices(), 2);
+			EXPECT_EQ(voices.GetNumVirtualVoices(), 0);
+			EXPECT_EQ(voices.GetNumStolen(), 1);
+
+			// Playing voice is virtualized on update once silenced
+			sounds[0].SetVolume(0.0f);
+			voices.Update();
+			EXPECT_TRUE(sounds[0].IsVirtual());
+			EXPECT_EQ(voices.GetNumActiveVoices(), 1);
+
+			// Stopping a virtual voice reattaches it
+			voices.Stop(sounds[0]);
+			EXPECT_FALSE(sounds[0].IsVirtual());
+			EXPECT_FALSE(sounds[0].IsPlaying());
+			EXPECT_FALSE(voices.IsTracked(sounds[0]));
+
+			for (MA::Sound& sound : sounds)
+				voices.Remove(sound);
+		}
+
+		// Number of tracked voices is limited, virtual voices included
+		{
+			std::array<MA::Sound, 3> sounds;
+			for (MA::Sound& sound : sounds)
+			{
+				ASSERT_TRUE(sound.Init(engineTest, "Some filepath", 0));
+				sound.SetLooping(true);
+				sound.SetVolume(0.0f);
+			}
+
+			JPL::VoiceManager voices;
+			ASSERT_TRUE(voices.Init(engineTest, { .MaxVoices = 1, .MaxVirtualVoices = 1, .StealFadeInMilliseconds = 0 }));
+
+			EXPECT_TRUE(voices.Play(sounds[0]));
+			EXPECT_TRUE(voices.Play(sounds[1]));
+			EXPECT_EQ(voices.GetNumVirtualVoices(), 2);
+
+			EXPECT_FALSE(voices.Play(sounds[2]));
+			sounds[2].SetVolume(1.0f);
+			EXPECT_FALSE(voices.Play(sounds[2]));
+			EXPECT_EQ(voices.GetNumRejected(), 2);
+			EXPECT_FALSE(voices.IsTracked(sounds[2]));
+
+			// Categories without a limit are not counted
+			EXPECT_EQ(voices.GetNumVoices(0), 0);
+
+			for (MA::Sound& sound : sounds)
+				voices.Stop(sound);
+		}
+
+		// Virtual one-shot that runs past its end stops being tracked
+		{
+			std::array<MA::Sound, 2> sounds;
+			for (MA::Sound& sound : sounds)
+			{
+				ASSERT_TRUE(sound.Init(engineTest, "Some filepath", 0));
+				sound.SetVolume(0.0f);
+				ASSERT_TRUE(sound.SeekToFrame(WaveformMockReader::durationInFrames - numFrames / 2));
+			}
+			sounds[1].SetLooping(true);
+
+			JPL::VoiceManager voices;
+			ASSERT_TRUE(voices.Init(engineTest, { .MaxVoices = 1, .StealFadeInMilliseconds = 0 }));
+
+			EXPECT_TRUE(voices.Play(sounds[0]));
+			EXPECT_TRUE(voices.Play(sounds[1]));
+			EXPECT_EQ(voices.GetNumVirtualVoices(), 2);
+
+			engineTest.Render(output, numFrames);
+			voices.Update();
+			EXPECT_EQ(voices.GetNumVirtualVoices(), 1);
+			EXPECT_FALSE(voices.IsTracked(sounds[0]));
+			EXPECT_FALSE(sounds[0].IsVirtual());
+			EXPECT_FALSE(sounds[0].IsPlaying());
+			EXPECT_TRUE(sounds[0].IsAtEnd());
+
+			// Looping one keeps going
+			EXPECT_TRUE(voices.IsTracked(sounds[1]));
+			EXPECT_TRUE(sounds[1].IsVirtual());
+
+			voices.Stop(sounds[1]);
+		}
+	}
+
+	TEST_F(MiniaudioWrappersTest, SoundPool)
+	{
+		static constexpr uint32 sampleRate = WaveformMockReader::sourceSampleRate;
+
+		MA::Engine engineTest;
+		ASSERT_TRUE(engineTest.Init({ .NumChannels = 2, .SampleRate = sampleRate, .VFS = &engineVfs, .Offline = true }));
+
+		JPL::SoundPool pool;
+		EXPECT_EQ(pool.Play(), nullptr);
+		ASSERT_TRUE(pool.Init(engineTest, "Some filepath", 2));
+		EXPECT_EQ(pool.GetCapacity(), 2);
+		EXPECT_EQ(pool.GetNumFree(), 2);
+
+		MA::Sound* first = pool.Play();
+		MA::Sound* second = pool.Play();
+		ASSERT_NE(first, nullptr);
+		ASSERT_NE(second, nullptr);
+		EXPECT_NE(first, second);
+		EXPECT_TRUE(first->IsPlaying());
+		EXPECT_EQ(first->GetLengthInFrames(), WaveformMockReader::durationInFrames);
+		EXPECT_EQ(pool.GetNumInUse(), 2);
+
+		// All of the instances are playing
+		EXPECT_EQ(pool.Play(), nullptr);
+
+		// Manually released instance is stopped and reused
+		pool.Release(*first);
+		EXPECT_FALSE(first->IsPlaying());
+		EXPECT_EQ(pool.GetNumFree(), 1);
+
+		first->SetVolume(0.5f);
+		MA::Sound* acquired = pool.Acquire();
+		EXPECT_EQ(acquired, first);
+		EXPECT_FALSE(acquired->IsPlaying());
+		EXPECT_EQ(acquired->GetVolume(), 1.0f);
+		EXPECT_EQ(acquired->GetCursorInFrames(), 0);
+
+		// Acquired instance that hasn't been started is not reclaimed
+		pool.Update();
+		EXPECT_EQ(pool.GetNumInUse(), 2);
+		EXPECT_TRUE(acquired->Start());
+
+		// Instances that reached their end are reclaimed automatically
+		const uint32 numFrames = static_cast<uint32>(WaveformMockReader::durationInFrames) + sampleRate / 10;
+		std::vector<float> output(numFrames * engineTest.GetNumChannels());
+		engineTest.Render(output, numFrames);
+		EXPECT_TRUE(first->IsAtEnd());
+		EXPECT_TRUE(second->IsAtEnd());
+
+		// Reclaimed instance is not at its end once acquired, so it's not reclaimed again before it's started
+		pool.Update();
+		EXPECT_EQ(pool.GetNumInUse(), 0);
+		MA::Sound* rewound = pool.Acquire();
+		ASSERT_NE(rewound, nullptr);
+		EXPECT_FALSE(rewound->IsAtEnd());
+		pool.Update();
+		EXPECT_EQ(pool.GetNumInUse(), 1);
+
+		// Implicit update of a full pool doesn't hand out the same instance twice
+		MA::Sound* other = pool.Acquire();
+		ASSERT_NE(other, nullptr);
+		EXPECT_NE(other, rewound);
+		EXPECT_EQ(pool.Acquire(), nullptr);
+		pool.StopAll();
+
+		MA::Sound* reused = pool.Play();
+		ASSERT_NE(reused, nullptr);
+		EXPECT_TRUE(reused->IsPlaying());
+		EXPECT_FALSE(reused->IsAtEnd());
+		EXPECT_EQ(pool.GetNumInUse(), 1);
+
+		pool.StopAll();
+		EXPECT_EQ(pool.GetNumFree(), 2);
+		EXPECT_FALSE(reused->IsPlaying());
+
+		// Scheduled stop of a released instance doesn't carry over
+		MA::Sound* scheduled = pool.Play();
+		ASSERT_NE(scheduled, nullptr);
+		scheduled->StopAtFrame(engineTest.GetTimeInFrames());
+		pool.Release(*scheduled);
+
+		MA::Sound* replayed = pool.Play();
+		ASSERT_EQ(replayed, scheduled);
+		engineTest.Render(output, 480);
+		EXPECT_TRUE(replayed->IsPlaying());
+		EXPECT_EQ(replayed->GetCursorInFrames(), 480);
+
+		pool.StopAll();
+	}
+
+	TEST_F(MiniaudioWrappersTest, AssetCache)
+	{
+		static constexpr uint64 assetSize = WaveformMockReader::durationInFrames * WaveformMockReader::sourceNumChannels * sizeof(float);
+
+		MA::Engine engineTest;
+		ASSERT_TRUE(engineTest.Init({ .NumChannels = 2, .VFS = &engineVfs, .Offline = true }));
+
+		JPL::AssetCache cache;
+		ASSERT_TRUE(cache.Init(engineTest, { .BudgetInBytes = assetSize * 2 }));
+
+		// Repeated loads share the decoded data
+		{
+			JPL::AssetCache::Handle a = cache.Load("A");
+			ASSERT_TRUE(a);
+			EXPECT_EQ(a.GetLengthInFrames(), WaveformMockReader::durationInFrames);
+			EXPECT_EQ(a.GetNumChannels(), WaveformMockReader::sourceNumChannels);
+			EXPECT_EQ(a.GetSampleRate(), WaveformMockReader::sourceSampleRate);
+			EXPECT_EQ(cache.GetUsedBytes(), assetSize);
+
+			JPL::AssetCache::Handle a2 = cache.Load("A");
+			EXPECT_EQ(a2.GetData().data(), a.GetData().data());
+			EXPECT_EQ(cache.GetNumHits(), 1);
+			EXPECT_EQ(cache.GetNumMisses(), 1);
+
+			// Referenced assets are not evicted, the budget is full
+			JPL::AssetCache::Handle b = cache.Load("B");
+			ASSERT_TRUE(b);
+			EXPECT_FALSE(cache.Load("C"));
+			EXPECT_FALSE(cache.IsCached("C"));
+			EXPECT_EQ(cache.GetUsedBytes(), assetSize * 2);
+
+			// Mark A as the most recently used
+			b.Reset();
+		}
+
+		// Unreferenced assets stay cached until room is needed, the least recently used goes first
+		EXPECT_TRUE(cache.IsCached("A"));
+		EXPECT_TRUE(cache.IsCached("B"));
+		EXPECT_TRUE(cache.Load("C"));
+		EXPECT_TRUE(cache.IsCached("A"));
+		EXPECT_FALSE(cache.IsCached("B"));
+		EXPECT_EQ(cache.GetNumEvictions(), 1);
+
+		// Pinned assets are not evicted
+		ASSERT_TRUE(cache.Pin("A"));
+		EXPECT_TRUE(cache.Load("B"));
+		EXPECT_TRUE(cache.IsCached("A"));
+		EXPECT_FALSE(cache.IsCached("C"));
+
+		cache.SetBudget(assetSize);
+		EXPECT_TRUE(cache.IsCached("A"));
+		EXPECT_FALSE(cache.IsCached("B"));
+		EXPECT_EQ(cache.GetUsedBytes(), assetSize);
+
+		// Over budget assets are evicted once unpinned
+		cache.SetBudget(0);
+		EXPECT_TRUE(cache.IsCached("A"));
+		cache.Unpin("A");
+		EXPECT_FALSE(cache.IsCached("A"));
+		EXPECT_EQ(cache.GetUsedBytes(), 0);
+
+		// Sounds playing the same asset have their own cursors
+		cache.SetBudget(assetSize);
+		{
+			JPL::CachedSound first;
+			JPL::CachedSound second;
+			ASSERT_TRUE(first.Init(cache, "A"));
+			ASSERT_TRUE(second.Init(cache, "A"));
+			EXPECT_EQ(first.GetAsset().GetData().data(), second.GetAsset().GetData().data());
+			EXPECT_EQ(first->GetLengthInFrames(), WaveformMockReader::durationInFrames);
+
+			ASSERT_TRUE(first->Start());
+
+			const uint32 numFrames = 480;
+			std::vector<float> output(numFrames * engineTest.GetNumChannels());
+			engineTest.Render(output, numFrames);
+
+			EXPECT_GT(first->GetCursorInFrames(), 0);
+			EXPECT_EQ(second->GetCursorInFrames(), 0);
+			EXPECT_EQ(cache.GetNumAssets(), 1);
+		}
+
+		cache.Trim();
+		EXPECT_EQ(cache.GetNumAssets(), 0);
+
+		// Asset that can't fit even after evicting everything else fails to load without evicting anything
+		{
+			JPL::VFS<VFSCustomTraits> vfs
+			{
+				.onCreateReader = [](const char* filepath)
+				{
+					const bool bLong = std::string_view(filepath).starts_with("Long");
+					return new WaveformMockReader(filepath, bLong ? WaveformMockReader::durationInFrames * 3 : WaveformMockReader::durationInFrames);
+				},
+				.onGetFileSize = [](const char* filepath) { return WaveformMockReader::fakeFileSize; }
+			};
+			vfs.init(JPL::gEngineAllocationCallbacks);
+
+			MA::Engine longEngine;
+			ASSERT_TRUE(longEngine.Init({ .NumChannels = 2, .VFS = &vfs, .Offline = true }));
+
+			JPL::AssetCache longCache;
+			ASSERT_TRUE(longCache.Init(longEngine, { .BudgetInBytes = assetSize * 2 }));
+
+			EXPECT_TRUE(longCache.Load("A"));
+			EXPECT_TRUE(longCache.IsCached("A"));
+
+			EXPECT_FALSE(longCache.Load("Long"));
+			EXPECT_FALSE(longCache.IsCached("Long"));
+			EXPECT_TRUE(longCache.IsCached("A"));
+			EXPECT_EQ(longCache.GetNumEvictions(), 0);
+			EXPECT_EQ(longCache.GetUsedBytes(), assetSize);
+		}
+	}
+
+	TEST_F(MiniaudioWrappersTest, AsyncSoundLoading)
+	{
+		MA::Engine engineTest;
+		ASSERT_TRUE(engineTest.Init({ .NumChannels = 2, .VFS = &engineVfs, .Offline = true }));
+
+		static constexpr uint32 numSounds = 8;
+		std::array<MA::Sound, numSounds> sounds;
+		std::array<MA::SoundLoad, numSounds> loads;
+		std::atomic<uint32> numLoaded{ 0 };
+
+		// Every sound is decoded, so each of them is a separate load
+		for (uint32 i = 0; i < numSounds; ++i)
+		{
+			const std::string filepath = std::format("Level sound {}", i);
+			loads[i] = sounds[i].InitAsync(engineTest, filepath.c_str(), MA_SOUND_FLAG_DECODE, [&numLoaded](bool bSucceeded)
+			{
+				if (bSucceeded)
+					numLoaded.fetch_add(1);
+			});
+			ASSERT_TRUE(loads[i].IsValid());
+		}
+
+		// Sounds can be started while loading
+		EXPECT_TRUE(sounds[0].Start());
+
+		EXPECT_TRUE(MA::SoundLoad::WaitAll(loads));
+		EXPECT_EQ(numLoaded.load(), numSounds);
+
+		for (uint32 i = 0; i < numSounds; ++i)
+		{
+			EXPECT_TRUE(loads[i].IsDone());
+			EXPECT_EQ(sounds[i].GetLengthInFrames(), WaveformMockReader::durationInFrames);
+		}
+
+		// Waiting again returns right away
+		EXPECT_TRUE(loads[0].Wait());
+		EXPECT_FALSE(MA::SoundLoad().IsDone());
+		EXPECT_FALSE(MA::SoundLoad().Wait());
+
+		// Handle can be dropped, reinitializing waits for the load
+		{
+			MA::Sound sound;
+			sound.InitAsync(engineTest, "Dropped handle", MA_SOUND_FLAG_DECODE);
+			EXPECT_TRUE(sound.Init(engineTest, "Some filepath", 0));
+		}
+
+		// Destroying or reinitializing the sound waits for the load, even if its handle is still kept
+		{
+			MA::SoundLoad load;
+			{
+				MA::Sound sound;
+				load = sound.InitAsync(engineTest, "Destroyed while loading", MA_SOUND_FLAG_DECODE);
+				ASSERT_TRUE(load.IsValid());
+			}
+			EXPECT_TRUE(load.IsDone());
+			EXPECT_TRUE(load.Wait());
+
+			MA::Sound sound;
+			const MA::SoundLoad reinitializedLoad = sound.InitAsync(engineTest, "Reinitialized while loading", MA_SOUND_FLAG_DECODE);
+			ASSERT_TRUE(reinitializedLoad.IsValid());
+			EXPECT_TRUE(sound.Init(engineTest, "Some filepath", 0));
+			EXPECT_TRUE(reinitializedLoad.IsDone());
+		}
+
+		// Format and length are known as soon as InitAsync returns, before the load is done
+		{
+			static std::atomic<bool> bReadsReleased{ false };
+
+			// Header and the first part of the data are read right away, the rest waits for the test
+			struct GatedReader : WaveformMockReader
+			{
+				using WaveformMockReader::WaveformMockReader;
+
+				void ReadData(void* outData, size_t inNumBytes)
+				{
+					while (GetStreamPosition() + inNumBytes > fakeFileSize * 3 / 4 && !bReadsReleased.load())
+						std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+					WaveformMockReader::ReadData(outData, inNumBytes);
+				}
+			};
+
+			struct GatedVFSTraits { using TStreamReader = GatedReader; };
+			JPL::VFS<GatedVFSTraits> gatedVfs
+			{
+				.onCreateReader = [](const char* filepath) { return new GatedReader(filepath); },
+				.onGetFileSize = [](const char* filepath) { return WaveformMockReader::fakeFileSize; }
+			};
+			gatedVfs.init(JPL::gEngineAllocationCallbacks);
+
+			MA::Engine gatedEngine;
+			ASSERT_TRUE(gatedEngine.Init({ .NumChannels = 2, .VFS = &gatedVfs, .Offline = true }));
+
+			MA::Sound sound;
+			const MA::SoundLoad load = sound.InitAsync(gatedEngine, "Gated sound", MA_SOUND_FLAG_DECODE);
+			ASSERT_TRUE(load.IsValid());
+
+			EXPECT_FALSE(load.IsDone());
+			EXPECT_EQ(sound.GetLengthInFrames(), WaveformMockReader::durationInFrames);
+			EXPECT_TRUE(sound.Start());
+
+			bReadsReleased.store(true);
+			EXPECT_TRUE(load.Wait());
+			EXPECT_TRUE(load.IsDone());
+		}
+	}
+
+	TEST_F(MiniaudioWrappersTest, ScheduledStartStop)
+	{
+		static constexpr uint32 sampleRate = WaveformMockReader::sourceSampleRate;
+
+		MA::Engine engineTest;
+		ASSERT_TRUE(engineTest.Init({ .NumChannels = 2, .SampleRate = sampleRate, .VFS = &engineVfs, .Offline = true }));
+
+		std::array<MA::Sound, 3> sounds;
+		for (MA::Sound& sound : sounds)
+		{
+			ASSERT_TRUE(sound.Init(engineTest, "Some filepath", 0));
+			sound.SetLooping(true);
+		}
+
+		std::vector<float> output(sampleRate * engineTest.GetNumChannels());
+		auto render = [&](uint32 numFrames) { engineTest.Render(output, numFrames); };
+
+		// Start and stop land on the exact frame, not on the block boundary
+		const uint64 startTime = engineTest.GetTimeInFrames() + 1000;
+		ASSERT_TRUE(sounds[0].StartAtFrame(startTime));
+		sounds[0].StopAtFrame(startTime + 777);
+
+		render(480);
+		EXPECT_EQ(sounds[0].GetCursorInFrames(), 0);
+
+		render(1000);
+		EXPECT_EQ(engineTest.GetTimeInFrames(), startTime + 480);
+		EXPECT_EQ(sounds[0].GetCursorInFrames(), 480);
+
+		render(1000);
+		EXPECT_EQ(sounds[0].GetCursorInFrames(), 777);
+		EXPECT_EQ(sounds[0].GetTimeInFrames(), 777);
+
+		// Restarting clears the stop time
+		ASSERT_TRUE(sounds[0].SeekToFrame(0));
+		ASSERT_TRUE(sounds[0].StartAtFrame(engineTest.GetTimeInFrames()));
+		render(1000);
+		EXPECT_EQ(sounds[0].GetCursorInFrames(), 1000);
+		ASSERT_TRUE(sounds[0].Stop());
+
+		// Batch of scheduled starts and stops
+		ASSERT_TRUE(sounds[0].SeekToFrame(0));
+		const uint64 batchTime = engineTest.GetTimeInFrames() + 100;
+
+		MA::CommandBatch batch;
+		for (MA::Sound& sound : sounds)
+			batch.ScheduleStart(sound, batchTime);
+		batch.ScheduleStop(sounds[2], batchTime + 300);
+		EXPECT_EQ(batch.GetNumCommands(), 4);
+
+		// Times are not rounded, even past what double can represent exactly
+		{
+			MA::CommandBatch farBatch;
+			farBatch.ScheduleStop(sounds[0], (uint64(1) << 53) + 1);
+			farBatch.ScheduleStop(sounds[0], std::numeric_limits<uint64>::max());
+			EXPECT_EQ(farBatch.GetCommands()[0].Time, (uint64(1) << 53) + 1);
+			EXPECT_EQ(farBatch.GetCommands()[1].Time, std::numeric_limits<uint64>::max());
+		}
+
+		ASSERT_TRUE(engineTest.Submit(batch));
+		EXPECT_TRUE(batch.IsEmpty());
+
+		render(1100);
+		EXPECT_EQ(sounds[0].GetCursorInFrames(), 1000);
+		EXPECT_EQ(sounds[1].GetCursorInFrames(), 1000);
+		EXPECT_EQ(sounds[2].GetCursorInFrames(), 300);
+		EXPECT_FALSE(sounds[2].IsPlaying());
+	}
+
+	TEST_F(MiniaudioWrappersTest, SoundEndQueue)
+	{
+		MA::Engine engineTest;
+		ASSERT_TRUE(engineTest.Init({ .NumChannels = 2, .VFS = &engineVfs, .Offline = true }));
+
+		std::vector<float> output(480 * engineTest.GetNumChannels());
+		auto startNearEnd = [](MA::Sound& sound)
+		{
+			ASSERT_TRUE(sound.SeekToFrame(WaveformMockReader::durationInFrames - 100));
+			ASSERT_TRUE(sound.Start());
+		};
+
+		JPL::SoundEndQueue endQueue(4);
+
+		MA::Sound watched;
+		ASSERT_TRUE(watched.Init(engineTest, "Some filepath", 0));
+		EXPECT_FALSE(endQueue.Watch(*std::make_unique<MA::Sound>()));
+		ASSERT_TRUE(endQueue.Watch(watched));
+		EXPECT_TRUE(endQueue.IsWatched(watched));
+
+		// Nothing ended yet
+		startNearEnd(watched);
+		EXPECT_EQ(endQueue.Drain(), 0);
+
+		engineTest.Render(output, 480);
+		EXPECT_TRUE(watched.IsAtEnd());
+
+		std::vector<MA::Sound*> ended;
+		EXPECT_EQ(endQueue.Drain([&ended](MA::Sound& sound) { ended.push_back(&sound); }), 1);
+		ASSERT_EQ(ended.size(), 1);
+		EXPECT_EQ(ended[0], &watched);
+
+		// Watched sound keeps notifying every time it ends
+		startNearEnd(watched);
+		engineTest.Render(output, 480);
+		EXPECT_EQ(endQueue.Drain(), 1);
+
+		// Released sound is destroyed once its end has been delivered
+		auto oneShot = std::make_unique<MA::Sound>();
+		ASSERT_TRUE(oneShot->Init(engineTest, "Some filepath", 0));
+		MA::Sound* released = endQueue.WatchAndRelease(std::move(oneShot));
+		ASSERT_NE(released, nullptr);
+		startNearEnd(*released);
+		EXPECT_EQ(endQueue.GetNumWatched(), 2);
+
+		engineTest.Render(output, 480);
+		EXPECT_EQ(endQueue.Drain(), 1);
+		EXPECT_EQ(endQueue.GetNumWatched(), 1);
+
+		// Pending events of unwatched sounds are discarded
+		startNearEnd(watched);
+		engineTest.Render(output, 480);
+		endQueue.Unwatch(watched);
+		EXPECT_FALSE(endQueue.IsWatched(watched));
+		EXPECT_EQ(endQueue.Drain(), 0);
+
+		// Unwatched sound doesn't notify
+		startNearEnd(watched);
+		engineTest.Render(output, 480);
+		EXPECT_EQ(endQueue.Drain(), 0);
+		EXPECT_EQ(endQueue.GetNumDropped(), 0);
+	}
+
+	TEST_F(MiniaudioWrappersTest, MultipleEngines)
+	{
+		static constexpr uint32 numChannels = 2;
+		static constexpr uint64 numFrames = 1024;
+
+		MA::Engine engineA;
+		MA::Engine engineB;
+		ASSERT_TRUE(engineA.Init({ .NumChannels = numChannels, .VFS = &engineVfs, .Offline = true }));
+		ASSERT_TRUE(engineB.Init({ .NumChannels = numChannels, .VFS = &engineVfs, .Offline = true }));
+
+		// Nodes must be created in the node graph of the engine explicitly passed in
+		MA::SplitterNode splitter;
+		ASSERT_TRUE(splitter.Init(engineA, numChannels));
+		EXPECT_EQ(ma_node_get_node_graph(splitter.get()), &engineA->nodeGraph);
+
+		MA::EngineNode group;
+		ASSERT_TRUE(group.InitGroup(engineB, { .NumInChannels = numChannels, .NumOutChannels = numChannels }));
+		EXPECT_EQ(ma_node_get_node_graph(group.get()), &engineB->nodeGraph);
+		EXPECT_EQ(group->pEngine, engineB.get());
+
+		MA::LPFNode lpf;
+		ASSERT_TRUE(lpf.Init(engineA, numChannels, 1'000.0, 1));
+		EXPECT_EQ(ma_node_get_node_graph(lpf.get()), &engineA->nodeGraph);
+
+		MA::HPFNode hpf;
+		ASSERT_TRUE(hpf.Init(engineB, numChannels, 1'000.0, 1));
+		EXPECT_EQ(ma_node_get_node_graph(hpf.get()), &engineB->nodeGraph);
+
+		static constexpr int ZERO_FLAGS = 0;
+		TBaseNode<node_base_mock<ZERO_FLAGS>> customNode;
+		ASSERT_TRUE(customNode.Init(NodeLayout().WithInputs(numChannels).WithOutputs(numChannels).WithEngine(engineB)));
+		EXPECT_EQ(ma_node_get_node_graph(customNode.get()), &engineB->nodeGraph);
+
+		MA::Sound sound;
+		ASSERT_TRUE(sound.Init(engineA, "Some filepath", 0));
+		EXPECT_EQ(sound->engineNode.pEngine, engineA.get());
+
+		// Independent engines can be processed concurrently
+		std::vector<float> outputA(numFrames * numChannels);
+		std::vector<float> outputB(numFrames * numChannels);
+		uint64 framesRenderedA = 0;
+		uint64 framesRenderedB = 0;
+		{
+			std::jthread renderA([&] { framesRenderedA = engineA.Render(outputA, numFrames); });
+			std::jthread renderB([&] { framesRenderedB = engineB.Render(outputB, numFrames); });
+		}
+		EXPECT_EQ(framesRenderedA, numFrames);
+		EXPECT_EQ(framesRenderedB, numFrames);
+	}
+
+	TEST_F(MiniaudioWrappersTest, ParallelSubmixNode)
+	{
+		static constexpr uint32 numChannels = 2;
+		static constexpr uint32 numSubmixes = 4;
+		static constexpr float submixValue = 0.25f;
+
+		MA::Engine mainEngine;
+		ASSERT_TRUE(mainEngine.Init({ .NumChannels = numChannels, .VFS = &engineVfs, .Offline = true }));
+
+		ParallelSubmixNode uninitSubmixNode;
+		EXPECT_FALSE(uninitSubmixNode.IsInitialized());
+		EXPECT_FALSE(uninitSubmixNode.Init(mainEngine, { .NumSubmixes = 0 }));
+
+		ParallelSubmixNode submixNode;
+		ASSERT_TRUE(submixNode.Init(mainEngine, { .NumSubmixes = numSubmixes, .NumWorkerThreads = 2 }));
+		EXPECT_TRUE(submixNode.IsInitialized());
+		EXPECT_EQ(submixNode.GetNumSubmixes(), numSubmixes);
+		EXPECT_EQ(submixNode.GetNumWorkerThreads(), 2);
+
+		// Each submix outputs a constant value
+		static constexpr int ZERO_FLAGS = 0;
+		std::vector<TBaseNode<node_base_mock<ZERO_FLAGS>>> generators(numSubmixes);
+		for (uint32 i = 0; i < numSubmixes; ++i)
+		{
+			MA::Engine& submix = submixNode.GetSubmix(i);
+			EXPECT_TRUE(submix.IsOffline());
+			EXPECT_EQ(submix.GetSampleRate(), mainEngine.GetSampleRate());
+			EXPECT_EQ(submix->pResourceManager, mainEngine->pResourceManager);
+
+			ASSERT_TRUE(generators[i].Init(NodeLayout().WithOutputs(numChannels).WithEngine(submix)));
+			generators[i]->onProcess = [](JPL::ProcessCallbackData& data)
+			{
+				auto output = data.GetOutputBuffer(0);
+				for (uint32 frame = 0; frame < output.getNumFrames(); ++frame)
+					for (uint32 channel = 0; channel < output.getNumChannels(); ++channel)
+						output.getSample(channel, frame) = submixValue;
+			};
+			ASSERT_TRUE(generators[i].OutputBus(0).AttachTo(submix.GetEndpointBus()));
+		}
+
+		ASSERT_TRUE(submixNode.GetOutputBus().AttachTo(mainEngine.GetEndpointBus()));
+
+		// Render more than a single processing block to make sure the submixes are rendered in chunks
+		const uint64 numFrames = mainEngine.GetProcessingSizeInFrames() * 3 + 7;
+		std::vector<float> output(numFrames * numChannels);
+		EXPECT_EQ(mainEngine.Render(output, numFrames), numFrames);
+
+		for (const float sample : output)
+			EXPECT_FLOAT_EQ(sample, submixValue * numSubmixes);
+	}
+
 	TEST_F(MiniaudioWrappersTest, SplitterNode)
 	{
 		MA::SplitterNode uninitSplitterNode;
@@ -22,6 +22,7 @@
 #include "MiniaudioCpp/Core.h"
 #include "MiniaudioCpp/ErrorReporting.h"
 #include "MiniaudioCpp/MiniaudioWrappers.h"
+#include "MiniaudioCpp/PoolAllocator.h"
 
 #include "miniaudio/miniaudio.h"
 
@@ -31,12 +32,6 @@
 #include <iostream>
 #include <gtest/gtest.h>
 
-//==========================================================================
-using AllocationCallbackData = std::atomic<uint64_t>;
-
-inline static std::atomic<uint64_t> sMemoryUsedByEngine{ 0 };
-
-
 //==========================================================================
 static void JPLTraceCallback(const char* message)
 {
@@ -51,87 +46,13 @@ MA::Engine& GetMiniaudioEngine(void* /*context*/)
 }
 
 //==========================================================================
-// TODO: JP. wrap this into a proper sufix allocator
-void MemFreeCallback(void* p, void* pUserData)
+JPL::PoolAllocator& GetAllocator()
 {
-	if (p == NULL)
-		return;
-
-	constexpr auto offset = std::max(sizeof(int), alignof(max_align_t));
-
-	char* buffer = (char*)p - offset; //get the start of the buffer
-	int* sizeBox = (int*)buffer;
-
-	// Memory tracking
-	{
-		auto& allocatedData = *static_cast<AllocationCallbackData*>(pUserData);
-		allocatedData -= *sizeBox;
-	}
-
-#ifdef LOG_MEMORY
-	JPL_INFO_TAG("Audio", "Freed mem KB : {0}", *sizeBox / 1000.0f);
-#endif
-	ma_free(buffer, nullptr);
+	// Constructed before and destroyed after any of the engines
+	static JPL::PoolAllocator sAllocator;
+	return sAllocator;
 }
 
-void* MemAllocCallback(size_t sz, void* pUserData)
-{
-	constexpr auto offset = std::max(sizeof(int), alignof(max_align_t));
-
-	char* buffer = (char*)ma_malloc(sz + offset, nullptr); //allocate offset extra bytes 
-	if (buffer == NULL)
-		return NULL; // no memory! 
-
-	// Memory tracking
-	{
-		auto& allocatedData = *static_cast<AllocationCallbackData*>(pUserData);
-		allocatedData += sz;
-	}
-
-	int* sizeBox = (int*)buffer;
-	*sizeBox = (int)sz; //store the size in first sizeof(int) bytes!
-
-#ifdef LOG_MEMORY
-	JPL_INFO_TAG("Audio", "Allocated mem KB : {0}", *sizeBox / 1000.0f);
-#endif
-	return buffer + offset; //return buffer after offset bytes!
-}
-
-void* MemReallocCallback(void* p, size_t sz, void* pUserData)
-{
-	if (p == nullptr)
-		return MemAllocCallback(sz, pUserData);
-
-	constexpr auto offset = std::max(sizeof(int), alignof(max_align_t));
-
-	auto* buffer = (char*)p - offset; //get the start of the buffer
-	int* sizeBox = (int*)buffer;
-
-	// Memory tracking
-	{
-		auto& allocatedData = *static_cast<AllocationCallbackData*>(pUserData);
-		allocatedData += (sz - *sizeBox);
-	}
-
-	*sizeBox = (int)sz;
-
-	auto* newBuffer = (char*)ma_realloc(buffer, sz, NULL);
-	if (newBuffer == NULL)
-		return NULL;
-
-#ifdef LOG_MEMORY
-	JPL_INFO_TAG("Audio", "Reallocated mem KB : {0}", sz / 1000.0f);
-#endif
-	return newBuffer + offset;
-}
-
-ma_allocation_callbacks gMAAllocationCallbacks{
-	.pUserData = &sMemoryUsedByEngine,
-	.onMalloc = MemAllocCallback,
-	.onRealloc = MemReallocCallback,
-	.onFree = MemFreeCallback
-};
-
 //==========================================================================
 static void Main(int argc, char* argv[])
 {
@@ -139,11 +60,7 @@ static void Main(int argc, char* argv[])
 	JPL::Trace = JPLTraceCallback;
 
 	JPL::GetMiniaudioEngine = GetMiniaudioEngine;
-#ifdef JPL_PLATFORM_WINDOWS
-	JPL::gEngineAllocationCallbacks = &gMAAllocationCallbacks;
-#else
-	JPL::gEngineAllocationCallbacks = nullptr;
-#endif
+	JPL::gEngineAllocationCallbacks = GetAllocator().GetCallbacks(JPL::EAllocationCategory::Nodes);
 }
 
 